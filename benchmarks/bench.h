@@ -0,0 +1,95 @@
+/**
+ * Shared helpers for the benchmarks.
+ */
+
+#ifndef STRINGHELPERS_BENCH_H
+#define STRINGHELPERS_BENCH_H
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+
+/**
+ * Keeps the compiler from optimizing away 'value'.
+ */
+template<typename T>
+inline void do_not_optimize(const T &value)
+{
+        asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Runs 'body' 'iterations' times and returns the average nanoseconds per iteration.
+ */
+template<typename F>
+inline double time_ns(size_t iterations, F &&body)
+{
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++)
+                body();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+}
+
+/**
+ * Prints one result line.
+ */
+inline void report(const char *name, double ns_per_op, const char *unit = "op")
+{
+        std::printf("%-48s %10.2f ns/%s\n", name, ns_per_op, unit);
+}
+
+/**
+ * Generates symbols shaped like a mixed exchange universe: equity tickers, futures contracts
+ * and OCC option symbols.
+ */
+inline std::vector<std::string> symbols(size_t amount, unsigned seed = 42)
+{
+        static constexpr char months[] = "FGHJKMNQUVXZ";
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> letter('A', 'Z');
+        std::uniform_int_distribution<int> digit(0, 9);
+        std::uniform_int_distribution<int> kind(0, 9);
+
+        std::vector<std::string> ret;
+        ret.reserve(amount);
+        while (ret.size() < amount)
+        {
+                std::string symbol;
+                int k = kind(rng);
+                if (k < 6)
+                {
+                        size_t len = 1 + rng() % 5;
+                        for (size_t i = 0; i < len; i++)
+                                symbol += static_cast<char>(letter(rng));
+                }
+                else if (k < 9)
+                {
+                        symbol += static_cast<char>(letter(rng));
+                        symbol += static_cast<char>(letter(rng));
+                        symbol += months[rng() % 12];
+                        symbol += static_cast<char>('0' + digit(rng));
+                }
+                else
+                {
+                        for (size_t i = 0; i < 4; i++)
+                                symbol += static_cast<char>(letter(rng));
+                        symbol += "  2412";
+                        symbol += static_cast<char>('0' + digit(rng));
+                        symbol += static_cast<char>('0' + digit(rng));
+                        symbol += rng() % 2 ? 'C' : 'P';
+                        for (size_t i = 0; i < 8; i++)
+                                symbol += static_cast<char>('0' + digit(rng));
+                }
+                ret.push_back(std::move(symbol));
+        }
+        return ret;
+}
+}
+
+#endif //STRINGHELPERS_BENCH_H
@@ -0,0 +1,37 @@
+#include <string>
+#include <string_view>
+
+#include "bench.h"
+#include "stringhelpers/stringhelpers.h"
+
+template<typename F>
+void run(const char *name, std::string_view input, F &&body)
+{
+        body();
+        double ns = bench::time_ns(200, body);
+        bench::report(name, ns / static_cast<double>(input.length()) * 1024, "KiB");
+}
+
+int main()
+{
+        // A large trailing buffer whose only delimiters are near its start, so every search
+        // scans almost all of it backward.
+        std::string input = "35=D|55=ESZ4|\n";
+        for (const std::string &symbol: bench::symbols(40000))
+                input += symbol;
+        std::string_view view = input;
+        std::printf("%zu bytes\n", input.length());
+
+        run("string_view::rfind('\\n')", view, [&] { bench::do_not_optimize(view.rfind('\n')); });
+        run("find_last(string, '\\n')", view, [&] { bench::do_not_optimize(strh::find_last(view, '\n')); });
+        run("string_view::rfind(\"|55=\")", view, [&] { bench::do_not_optimize(view.rfind("|55=")); });
+        run("find_last(string, \"|55=\")", view, [&] { bench::do_not_optimize(strh::find_last(view, "|55=")); });
+        run("string_view::rfind(14 characters)", view,
+            [&] { bench::do_not_optimize(view.rfind("35=D|55=ESZ4|\n")); });
+        run("find_last(string, 14 characters)", view,
+            [&] { bench::do_not_optimize(strh::find_last(view, "35=D|55=ESZ4|\n")); });
+        run("string_view::rfind(24 characters)", view,
+            [&] { bench::do_not_optimize(view.rfind("8=FIX.4.4|35=D|55=ESZ4|\n")); });
+        run("find_last(string, 24 characters)", view,
+            [&] { bench::do_not_optimize(strh::find_last(view, "8=FIX.4.4|35=D|55=ESZ4|\n")); });
+}
@@ -0,0 +1,69 @@
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
+
+#include "bench.h"
+#include "stringhelpers/compiled_format.h"
+#include "stringhelpers/stringhelpers.h"
+
+template<typename F>
+void run(const char *name, size_t lines, F &&body)
+{
+        body();
+        double ns = bench::time_ns(20, body);
+        bench::report(name, ns / static_cast<double>(lines), "line");
+}
+
+int main()
+{
+        std::vector<std::string> symbols = bench::symbols(20000);
+        std::printf("%zu lines of \"symbol|quantity|price\"\n", symbols.size());
+
+        run("stringstream", symbols.size(), [&] {
+                for (size_t i = 0; i < symbols.size(); i++)
+                {
+                        std::stringstream ss;
+                        ss.setf(std::ios::fixed);
+                        ss.precision(2);
+                        ss << symbols[i] << '|' << i << '|' << 5900.25 + static_cast<double>(i);
+                        bench::do_not_optimize(ss.str());
+                }
+        });
+        run("snprintf", symbols.size(), [&] {
+                char buffer[128];
+                for (size_t i = 0; i < symbols.size(); i++)
+                {
+                        std::snprintf(buffer, sizeof(buffer), "%s|%zu|%.2f", symbols[i].c_str(), i,
+                                      5900.25 + static_cast<double>(i));
+                        bench::do_not_optimize(buffer);
+                }
+        });
+        run("from_parameter_pack", symbols.size(), [&] {
+                for (size_t i = 0; i < symbols.size(); i++)
+                        bench::do_not_optimize(strh::from_parameter_pack(symbols[i], i, 5900.25 + static_cast<double>(i)));
+        });
+#if defined(__cpp_lib_format)
+        run("std::format", symbols.size(), [&] {
+                for (size_t i = 0; i < symbols.size(); i++)
+                        bench::do_not_optimize(std::format("{}|{}|{:.2f}", symbols[i], i, 5900.25 + static_cast<double>(i)));
+        });
+#endif
+        run("compile<...>.format", symbols.size(), [&] {
+                for (size_t i = 0; i < symbols.size(); i++)
+                        bench::do_not_optimize(strh::compile<"{}|{}|{:.2f}">.format(symbols[i], i, 5900.25 + static_cast<double>(i)));
+        });
+        run("compile<...>.format_to", symbols.size(), [&] {
+                char buffer[512];
+                for (size_t i = 0; i < symbols.size(); i++)
+                {
+                        char *end = strh::compile<"{}|{}|{:.2f}">.format_to(buffer, symbols[i], i, 5900.25 + static_cast<double>(i));
+                        bench::do_not_optimize(end);
+                }
+        });
+}
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench.h"
+#include "stringhelpers/fuzzy.h"
+
+/**
+ * The textbook O(n * m) Levenshtein distance with one row of the table.
+ */
+size_t table_edit_distance(std::string_view a, std::string_view b)
+{
+        std::vector<size_t> row(b.length() + 1);
+        for (size_t j = 0; j <= b.length(); j++)
+                row[j] = j;
+        for (size_t i = 1; i <= a.length(); i++)
+        {
+                size_t diagonal = row[0];
+                row[0] = i;
+                for (size_t j = 1; j <= b.length(); j++)
+                {
+                        size_t above = row[j];
+                        row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] != b[j - 1])});
+                        diagonal = above;
+                }
+        }
+        return row[b.length()];
+}
+
+template<typename F>
+void run(const char *name, size_t queries, F &&body)
+{
+        body();
+        double ns = bench::time_ns(3, body);
+        bench::report(name, ns / static_cast<double>(queries), "query");
+}
+
+int main()
+{
+        std::vector<std::string> symbols = bench::symbols(100000);
+        std::vector<std::string> queries = {"AAPL", "ESZ4", "MSFTT", "NQH5", "SPXW  241220C05900000"};
+        std::printf("%zu symbols, %zu queries\n", symbols.size(), queries.size());
+
+        run("table distance, top 5", queries.size(), [&] {
+                for (const std::string &query: queries)
+                {
+                        std::vector<std::pair<size_t, size_t>> distances;
+                        distances.reserve(symbols.size());
+                        for (size_t i = 0; i < symbols.size(); i++)
+                                distances.emplace_back(table_edit_distance(query, symbols[i]), i);
+                        std::partial_sort(distances.begin(), distances.begin() + 5, distances.end());
+                        bench::do_not_optimize(distances[0]);
+                }
+        });
+        run("edit_distance, top 5", queries.size(), [&] {
+                for (const std::string &query: queries)
+                {
+                        std::vector<std::pair<size_t, size_t>> distances;
+                        distances.reserve(symbols.size());
+                        for (size_t i = 0; i < symbols.size(); i++)
+                                distances.emplace_back(strh::edit_distance(query, symbols[i]), i);
+                        std::partial_sort(distances.begin(), distances.begin() + 5, distances.end());
+                        bench::do_not_optimize(distances[0]);
+                }
+        });
+        run("within_distance(2)", queries.size(), [&] {
+                for (const std::string &query: queries)
+                {
+                        size_t matches = 0;
+                        for (const std::string &symbol: symbols)
+                                matches += strh::within_distance(query, symbol, 2);
+                        bench::do_not_optimize(matches);
+                }
+        });
+        run("nearest, top 5", queries.size(), [&] {
+                for (const std::string &query: queries)
+                        bench::do_not_optimize(strh::nearest(query, symbols, 5));
+        });
+}
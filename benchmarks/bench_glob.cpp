@@ -0,0 +1,68 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench.h"
+#include "stringhelpers/glob.h"
+
+template<typename F>
+void run(const char *name, size_t strings, F &&body)
+{
+        body();
+        double ns = bench::time_ns(5, body);
+        bench::report(name, ns / static_cast<double>(strings), "string");
+}
+
+int main()
+{
+        std::vector<std::string> symbols = bench::symbols(20000);
+        std::vector<std::string> patterns;
+        for (size_t i = 0; i < 2000; i++)
+        {
+                const std::string &symbol = symbols[i];
+                switch (i % 4)
+                {
+                case 0:
+                        patterns.push_back(symbol.substr(0, 2) + "*.CME");
+                        break;
+                case 1:
+                        patterns.push_back("?" + symbol.substr(1, 2) + "*");
+                        break;
+                case 2:
+                        patterns.push_back(symbol + ".CME");
+                        break;
+                default:
+                        patterns.push_back(symbol.substr(0, 1) + "*" + symbol.substr(1, 1) + "?*");
+                        break;
+                }
+        }
+
+        std::vector<std::string> strings;
+        for (size_t i = 0; i < symbols.size(); i++)
+                strings.push_back(symbols[i] + (i % 3 == 0 ? ".CBT" : ".CME"));
+        std::printf("%zu patterns, %zu strings\n", patterns.size(), strings.size());
+
+        std::vector<strh::glob> globs;
+        strh::glob_set set;
+        for (const std::string &pattern: patterns)
+        {
+                globs.emplace_back(pattern);
+                set.add(pattern);
+        }
+
+        run("every glob", strings.size(), [&] {
+                size_t matches = 0;
+                for (const std::string &string: strings)
+                {
+                        for (const strh::glob &pattern: globs)
+                                matches += pattern.matches(string);
+                }
+                bench::do_not_optimize(matches);
+        });
+        run("glob_set::for_each_match", strings.size(), [&] {
+                size_t matches = 0;
+                for (const std::string &string: strings)
+                        set.for_each_match(string, [&](size_t) { matches++; });
+                bench::do_not_optimize(matches);
+        });
+}
@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <functional>
+#include <string_view>
+
+#include "bench.h"
+#include "stringhelpers/hash.h"
+
+/**
+ * Counts how many keys land in an already occupied bucket of a power-of-two table, the layout
+ * used by open-addressing maps that mask the low hash bits.
+ */
+template<typename Hash>
+size_t bucket_collisions(const std::vector<std::string_view> &keys, size_t buckets, Hash &&hash)
+{
+        std::vector<bool> used(buckets);
+        size_t collisions = 0;
+        for (std::string_view key : keys)
+        {
+                size_t bucket = hash(key) & (buckets - 1);
+                collisions += used[bucket];
+                used[bucket] = true;
+        }
+        return collisions;
+}
+
+template<typename Hash>
+void run(const char *name, const std::vector<std::string_view> &keys, Hash &&hash)
+{
+        size_t rounds = 20;
+        for (std::string_view key : keys)
+                bench::do_not_optimize(hash(key));
+        double ns = bench::time_ns(rounds, [&] {
+                for (std::string_view key : keys)
+                        bench::do_not_optimize(hash(key));
+        });
+        std::printf("%-32s %8.2f ns/key  %6zu bucket collisions\n", name,
+                    ns / static_cast<double>(keys.size()),
+                    bucket_collisions(keys, size_t(1) << 18, hash));
+}
+
+int main()
+{
+        std::vector<std::string> symbols = bench::symbols(100000);
+        std::sort(symbols.begin(), symbols.end());
+        symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+        std::shuffle(symbols.begin(), symbols.end(), std::mt19937(7));
+        std::vector<std::string_view> keys(symbols.begin(), symbols.end());
+        std::printf("%zu distinct symbols, 2^18 buckets\n", keys.size());
+
+        run("std::hash<std::string_view>", keys, std::hash<std::string_view>());
+        run("strh::hash", keys, [](std::string_view key) { return strh::hash(key); });
+        run("strh::hash_ignore_case", keys, [](std::string_view key) { return strh::hash_ignore_case(key); });
+}
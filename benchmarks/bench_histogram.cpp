@@ -0,0 +1,43 @@
+#include <array>
+#include <string>
+#include <string_view>
+
+#include "bench.h"
+#include "stringhelpers/stringhelpers.h"
+
+template<typename F>
+void run(const char *name, std::string_view input, F &&body)
+{
+        body();
+        double ns = bench::time_ns(50, body);
+        bench::report(name, ns / static_cast<double>(input.length()) * 1024, "KiB");
+}
+
+int main()
+{
+        std::string input;
+        size_t i = 0;
+        for (const std::string &symbol: bench::symbols(100000))
+                input += "55=\"" + symbol + "\"|38=" + std::to_string(100 * (1 + i++ % 7)) + "|\n";
+        std::string_view view = input;
+        std::printf("%zu bytes\n", input.length());
+
+        run("count x3 ('|', '\"', '\\n')", view, [&] {
+                bench::do_not_optimize(strh::count(view, '|'));
+                bench::do_not_optimize(strh::count(view, '"'));
+                bench::do_not_optimize(strh::count(view, '\n'));
+        });
+        run("count_any(string, \"|\\\"\\n\")", view, [&] { bench::do_not_optimize(strh::count_any(view, "|\"\n")); });
+        run("count x8", view, [&] {
+                for (char key: std::string_view("|\"\n=0123"))
+                        bench::do_not_optimize(strh::count(view, key));
+        });
+        run("count_any, 8 keys", view, [&] { bench::do_not_optimize(strh::count_any(view, "|\"\n=0123")); });
+        run("naive histogram", view, [&] {
+                std::array<size_t, 256> counts{};
+                for (char ch: view)
+                        counts[static_cast<unsigned char>(ch)]++;
+                bench::do_not_optimize(counts);
+        });
+        run("histogram", view, [&] { bench::do_not_optimize(strh::histogram(view)); });
+}
@@ -0,0 +1,47 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench.h"
+#include "stringhelpers/line_index.h"
+
+template<typename F>
+void run(const char *name, size_t bytes, F &&body)
+{
+        body();
+        double ns = bench::time_ns(10, body);
+        bench::report(name, ns / static_cast<double>(bytes), "byte");
+}
+
+int main()
+{
+        // A log of FIX-like orders, a few dozen bytes a line.
+        std::vector<std::string> symbols = bench::symbols(1000);
+        std::string text;
+        for (size_t i = 0; text.length() < (64 << 20); i++)
+                text += "35=D|55=" + symbols[i % symbols.size()] + "|38=" + std::to_string(i * 7919 % 10000) + "|\n";
+        std::printf("%zu bytes\n", text.length());
+
+        run("split_lines", text.length(), [&] { bench::do_not_optimize(strh::split_lines(text).size()); });
+        run("line_index", text.length(), [&] { bench::do_not_optimize(strh::line_index(text).size()); });
+        run("line_index, 4 threads", text.length(),
+            [&] { bench::do_not_optimize(strh::line_index(text, 4).size()); });
+
+        strh::line_index index(text);
+        size_t lines = index.size();
+        size_t reads = 1 << 20;
+        double ns = bench::time_ns(10, [&] {
+                size_t sum = 0;
+                for (size_t i = 0; i < reads; i++)
+                        sum += index.line(i * 7919 % lines).length();
+                bench::do_not_optimize(sum);
+        });
+        bench::report("line(i), random", ns / static_cast<double>(reads), "line");
+        ns = bench::time_ns(10, [&] {
+                size_t sum = 0;
+                for (size_t i = 0; i < reads; i++)
+                        sum += index.line_of(i * 7919 % text.length());
+                bench::do_not_optimize(sum);
+        });
+        bench::report("line_of, random", ns / static_cast<double>(reads), "lookup");
+}
@@ -0,0 +1,48 @@
+#include <string>
+#include <string_view>
+
+#include "bench.h"
+#include "stringhelpers/matchers.h"
+#include "stringhelpers/stringhelpers.h"
+
+/**
+ * Builds FIX-like messages, one per symbol, with '|' as the field separator.
+ */
+std::string messages(const std::vector<std::string> &symbols)
+{
+        std::string ret;
+        for (size_t i = 0; i < symbols.size(); i++)
+        {
+                ret += "8=FIX.4.4|9=" + std::to_string(90 + i % 10) + "|35=D|49=SENDER|56=TARGET|34="
+                       + std::to_string(i) + "|55=" + symbols[i] + "|54=" + std::to_string(1 + i % 2)
+                       + "|38=" + std::to_string(100 * (1 + i % 7)) + "|44=" + std::to_string(5900 + i % 50)
+                       + ".25|10=" + std::to_string(i % 256) + "|\n";
+        }
+        return ret;
+}
+
+template<typename F>
+void run(const char *name, std::string_view input, F &&body)
+{
+        body();
+        double ns = bench::time_ns(20, body);
+        bench::report(name, ns / static_cast<double>(input.length()) * 1024, "KiB");
+}
+
+int main()
+{
+        std::string input = messages(bench::symbols(20000));
+        std::string_view view = input;
+        std::printf("%zu bytes of messages\n", input.length());
+
+        run("find(string, \"35=\")", view, [&] { bench::do_not_optimize(strh::find(view, "35=")); });
+        run("find<\"35=\">(string)", view, [&] { bench::do_not_optimize(strh::find<"35=">(view)); });
+        run("count(string, \"|55=\")", view, [&] { bench::do_not_optimize(strh::count(view, "|55=")); });
+        run("count<\"|55=\">(string)", view, [&] { bench::do_not_optimize(strh::count<"|55=">(view)); });
+        run("split(string, '|')", view, [&] { bench::do_not_optimize(strh::split(view, '|')); });
+        run("split<'|'>(string)", view, [&] { bench::do_not_optimize(strh::split<'|'>(view)); });
+        run("replace(string, \"|\", \"\\x01\")", view,
+            [&] { bench::do_not_optimize(strh::replace(input, "|", "\x01")); });
+        run("replace<\"|\", \"\\x01\">(string)", view,
+            [&] { bench::do_not_optimize(strh::replace<"|", "\x01">(input)); });
+}
@@ -0,0 +1,51 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench.h"
+#include "stringhelpers/prefix_set.h"
+#include "stringhelpers/stringhelpers.h"
+
+template<typename F>
+void run(const char *name, size_t messages, F &&body)
+{
+        body();
+        double ns = bench::time_ns(20, body);
+        bench::report(name, ns / static_cast<double>(messages), "message");
+}
+
+int main()
+{
+        std::vector<std::string> symbols = bench::symbols(20000);
+        std::vector<std::string> routes;
+        for (size_t i = 0; i < 200; i++)
+                routes.push_back("35=D|55=" + symbols[i * 7].substr(0, 1 + i % 4));
+
+        std::vector<std::string> messages;
+        for (size_t i = 0; i < symbols.size(); i++)
+                messages.push_back("35=D|55=" + symbols[i] + "|54=1|38=100|");
+        std::printf("%zu routes, %zu messages\n", routes.size(), messages.size());
+
+        strh::prefix_set set(routes);
+
+        run("starts_with per route", messages.size(), [&] {
+                size_t matched = 0;
+                for (const std::string &message: messages)
+                {
+                        size_t longest = 0;
+                        for (const std::string &route: routes)
+                        {
+                                if (route.length() > longest && strh::starts_with(message, route))
+                                        longest = route.length();
+                        }
+                        matched += longest;
+                }
+                bench::do_not_optimize(matched);
+        });
+        run("prefix_set::match", messages.size(), [&] {
+                size_t matched = 0;
+                for (const std::string &message: messages)
+                        matched += set.match(message);
+                bench::do_not_optimize(matched);
+        });
+}
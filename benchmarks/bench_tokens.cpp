@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "bench.h"
+#include "stringhelpers/tokens.h"
+
+template<typename F>
+void run(const char *name, size_t tokens, F &&body)
+{
+        body();
+        double ns = bench::time_ns(10, body);
+        bench::report(name, ns / static_cast<double>(tokens), "token");
+}
+
+int main()
+{
+        // A universe with repeats, like the symbols of a day of trades.
+        std::vector<std::string> universe = bench::symbols(50000);
+        std::vector<std::string> strings;
+        for (size_t i = 0; i < 200000; i++)
+                strings.push_back(universe[(i * 7919) % universe.size()]);
+        std::vector<std::string_view> views(strings.begin(), strings.end());
+        std::printf("%zu tokens\n", strings.size());
+
+        run("std::sort, strings", strings.size(), [&] {
+                std::vector<std::string> copy = strings;
+                std::sort(copy.begin(), copy.end());
+                bench::do_not_optimize(copy.data());
+        });
+        run("std::sort, string_views", views.size(), [&] {
+                std::vector<std::string_view> copy = views;
+                std::sort(copy.begin(), copy.end());
+                bench::do_not_optimize(copy.data());
+        });
+        run("sort_tokens", views.size(), [&] {
+                std::vector<std::string_view> copy = views;
+                strh::sort_tokens(copy);
+                bench::do_not_optimize(copy.data());
+        });
+        run("sort + unique, strings", strings.size(), [&] {
+                std::vector<std::string> copy = strings;
+                std::sort(copy.begin(), copy.end());
+                copy.erase(std::unique(copy.begin(), copy.end()), copy.end());
+                bench::do_not_optimize(copy.data());
+        });
+        run("unordered_set<string_view>", views.size(), [&] {
+                std::unordered_set<std::string_view> distinct(views.begin(), views.end());
+                bench::do_not_optimize(distinct.size());
+        });
+        run("unique_tokens", views.size(), [&] { bench::do_not_optimize(strh::unique_tokens(views)); });
+        run("count_distinct", views.size(), [&] { bench::do_not_optimize(strh::count_distinct(views)); });
+}
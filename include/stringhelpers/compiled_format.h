@@ -0,0 +1,337 @@
+/**
+ * Format strings parsed at compile time.
+ */
+
+#ifndef STRINGHELPERS_COMPILED_FORMAT_H
+#define STRINGHELPERS_COMPILED_FORMAT_H
+
+#include <array>
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "stringhelpers/literal.h"
+#include "stringhelpers/stringhelpers.h"
+
+namespace strh
+{
+
+/**
+ * Helper functions for compiled formats.
+ *
+ * @relatealso strh
+ */
+namespace priv_helpers
+{
+
+/**
+ * One replacement field of a format string.
+ */
+struct format_field
+{
+        /** The end of the literal text before the field, in the unescaped text. */
+        size_t text_end = 0;
+        /** 'x' for hexadecimal integers, 'f' for fixed floating point, '\0' for the default. */
+        char type = '\0';
+        /** The number of decimals of a fixed floating point, or '-1'. */
+        int precision = -1;
+};
+
+/**
+ * A format string split into its literal text, with '{{' and '}}' unescaped, and its fields.
+ *
+ * @tparam N the size of the format string, which bounds both.
+ */
+template<size_t N>
+struct parsed_format
+{
+        std::array<char, N> text{};
+        size_t text_length = 0;
+        std::array<format_field, N> fields{};
+        size_t field_count = 0;
+};
+
+/**
+ * Not constexpr, so calling it while parsing a format string fails the compilation with 'message'.
+ */
+inline void format_string_error(const char *message)
+{
+        (void) message;
+}
+
+/**
+ * Parses 'format'.
+ */
+template<size_t N>
+consteval parsed_format<N> parse_format(const string_literal<N> &format)
+{
+        parsed_format<N> ret;
+        std::string_view string = format;
+        for (size_t pos = 0; pos < string.length(); pos++)
+        {
+                char ch = string[pos];
+                if (ch == '}')
+                {
+                        if (pos + 1 == string.length() || string[pos + 1] != '}')
+                                format_string_error("unmatched '}' in format string");
+                        ret.text[ret.text_length++] = '}';
+                        pos++;
+                        continue;
+                }
+                if (ch != '{')
+                {
+                        ret.text[ret.text_length++] = ch;
+                        continue;
+                }
+                if (pos + 1 < string.length() && string[pos + 1] == '{')
+                {
+                        ret.text[ret.text_length++] = '{';
+                        pos++;
+                        continue;
+                }
+
+                size_t close = string.find('}', pos);
+                if (close == std::string_view::npos)
+                        format_string_error("unmatched '{' in format string");
+
+                format_field field{ret.text_length};
+                std::string_view spec = string.substr(pos + 1, close - pos - 1);
+                if (spec == ":x")
+                {
+                        field.type = 'x';
+                }
+                else if (spec.starts_with(":.") && spec.ends_with('f') && spec.length() > 3)
+                {
+                        field.type = 'f';
+                        field.precision = 0;
+                        for (char digit: spec.substr(2, spec.length() - 3))
+                        {
+                                if (digit < '0' || digit > '9')
+                                        format_string_error("invalid precision in format string");
+                                field.precision = field.precision * 10 + (digit - '0');
+                        }
+                }
+                else if (!spec.empty())
+                {
+                        format_string_error("unsupported format spec; use {}, {:x} or {:.Nf}");
+                }
+                ret.fields[ret.field_count++] = field;
+                pos = close;
+        }
+        return ret;
+}
+
+/**
+ * Returns the most characters 'value' can take with 'field'.
+ */
+template<typename T>
+inline size_t max_field_length(const format_field &field, const T &value)
+{
+        if constexpr (std::is_same_v<T, bool>)
+                return 5;
+        else if constexpr (std::is_same_v<T, char>)
+                return 1;
+        else if constexpr (std::is_integral_v<T>)
+                return field.type == 'x' ? std::numeric_limits<T>::digits / 4 + 2 : std::numeric_limits<T>::digits10 + 2;
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+                if (field.precision < 0)
+                        return 32;
+                // Below 1e16 the integer part has at most 16 digits; beyond it, up to as many as the
+                // largest value of 'T' has.
+                constexpr size_t max_digits = std::numeric_limits<T>::max_exponent10 + 1;
+                size_t integer_digits = std::abs(value) < 1e16 ? 16 : max_digits;
+                return 2 + integer_digits + static_cast<size_t>(field.precision);
+        }
+        else
+                return std::string_view(value).length();
+}
+
+/**
+ * Returns whether an argument of type 'T' can fill 'field': '{:x}' takes integers and '{:.Nf}'
+ * floating point numbers.
+ */
+template<typename T>
+constexpr bool field_accepts(const format_field &field)
+{
+        if (field.type == 'x')
+                return std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>;
+        if (field.type == 'f')
+                return std::is_floating_point_v<T>;
+        return true;
+}
+
+/**
+ * Returns the end of the characters 'to_chars' wrote, which always fit the bound of
+ * 'max_field_length'.
+ */
+inline char *checked_end(std::to_chars_result result)
+{
+        assert(result.ec == std::errc() && "max_field_length is too small");
+        return result.ptr;
+}
+
+template<typename T>
+inline char *write_field(char *out, const format_field &field, const T &value)
+{
+        if constexpr (std::is_same_v<T, bool>)
+        {
+                std::string_view text = value ? "true" : "false";
+                std::memcpy(out, text.data(), text.length());
+                return out + text.length();
+        }
+        else if constexpr (std::is_same_v<T, char>)
+        {
+                *out = value;
+                return out + 1;
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+                return checked_end(std::to_chars(out, out + max_field_length(field, value), value,
+                                                 field.type == 'x' ? 16 : 10));
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+                char *end = out + max_field_length(field, value);
+                if (field.precision < 0)
+                        return checked_end(std::to_chars(out, end, value));
+                return checked_end(std::to_chars(out, end, value, std::chars_format::fixed, field.precision));
+        }
+        else
+        {
+                std::string_view text = value;
+                std::memcpy(out, text.data(), text.length());
+                return out + text.length();
+        }
+}
+
+template<typename T>
+concept formattable = std::is_arithmetic_v<T> || std::is_convertible_v<const T &, std::string_view>;
+}
+
+/**
+ * A format string parsed at compile time, such as 'compile<"{}|{}|{:.2f}">'.
+ *
+ * Supports '{}' for any argument, '{:x}' for hexadecimal integers, '{:.Nf}' for floating point with
+ * 'N' decimals, and '{{' and '}}' for literal braces. Arguments can be strings (anything convertible
+ * to 'std::string_view'), characters, 'bool's and numbers; numbers are written with 'to_chars'. A
+ * malformed format string, a wrong number of arguments or an argument of the wrong type for its
+ * spec fails to compile.
+ *
+ * The literal text between fields is copied with sizes known at compile time, and the output size
+ * is bounded from the argument types before anything is written, so 'format_to' writes straight
+ * into the caller's buffer with no checks per field.
+ *
+ * @tparam Format the format string.
+ */
+template<string_literal Format>
+class compiled_format
+{
+        static constexpr priv_helpers::parsed_format<sizeof(Format.data)> parsed = priv_helpers::parse_format(Format);
+
+public:
+        /** The number of arguments the format takes. */
+        static constexpr size_t arg_count = parsed.field_count;
+
+        /**
+         * Bounds the length of the output for 'args'.
+         *
+         * @param args the arguments that will be formatted.
+         *
+         * @return the most characters 'format_to' writes for 'args'.
+         */
+        template<priv_helpers::formattable... Args>
+        static size_t max_length(const Args &... args)
+        {
+                static_assert(sizeof...(Args) == arg_count, "wrong number of arguments for the format string");
+                static_assert(accepts<Args...>(std::index_sequence_for<Args...>()),
+                              "argument type does not match its format spec");
+                return max_length_impl(std::index_sequence_for<Args...>(), args...);
+        }
+
+        /**
+         * Writes the format with 'args' to 'out'.
+         *
+         * @param out the buffer to write to, with room for at least 'max_length(args...)' characters.
+         * @param args the arguments to format.
+         *
+         * @return the end of the written characters.
+         */
+        template<priv_helpers::formattable... Args>
+        static char *format_to(char *out, const Args &... args)
+        {
+                static_assert(sizeof...(Args) == arg_count, "wrong number of arguments for the format string");
+                static_assert(accepts<Args...>(std::index_sequence_for<Args...>()),
+                              "argument type does not match its format spec");
+                STRH_INSTRUMENT(compiled_format, 0);
+                return format_to_impl(out, std::index_sequence_for<Args...>(), args...);
+        }
+
+        /**
+         * Formats 'args' into a new string.
+         *
+         * @param args the arguments to format.
+         *
+         * @return the formatted string.
+         *
+         * @note Allocates once, unless the result fits the small string buffer.
+         */
+        template<priv_helpers::formattable... Args>
+        static std::string format(const Args &... args)
+        {
+                std::string ret;
+                ret.resize(max_length(args...));
+                ret.resize(format_to(ret.data(), args...) - ret.data());
+                return ret;
+        }
+
+private:
+        template<typename... Args, size_t... I>
+        static constexpr bool accepts(std::index_sequence<I...>)
+        {
+                if constexpr (sizeof...(Args) != arg_count)
+                        return true;
+                else
+                        return (priv_helpers::field_accepts<Args>(parsed.fields[I]) && ... && true);
+        }
+
+        template<size_t... I, typename... Args>
+        static size_t max_length_impl(std::index_sequence<I...>, const Args &... args)
+        {
+                return parsed.text_length + (priv_helpers::max_field_length(parsed.fields[I], args) + ... + 0);
+        }
+
+        template<size_t I>
+        static char *write_text(char *out)
+        {
+                constexpr size_t start = I == 0 ? 0 : parsed.fields[I - 1].text_end;
+                constexpr size_t end = I == arg_count ? parsed.text_length : parsed.fields[I].text_end;
+                if constexpr (end > start)
+                        std::memcpy(out, parsed.text.data() + start, end - start);
+                return out + (end - start);
+        }
+
+        template<size_t... I, typename... Args>
+        static char *format_to_impl(char *out, std::index_sequence<I...>, const Args &... args)
+        {
+                ((out = priv_helpers::write_field(write_text<I>(out), parsed.fields[I], args)), ...);
+                return write_text<arg_count>(out);
+        }
+};
+
+/**
+ * The compiled form of 'Format'.
+ *
+ * @see compiled_format
+ */
+template<string_literal Format>
+inline constexpr compiled_format<Format> compile{};
+}
+
+#endif //STRINGHELPERS_COMPILED_FORMAT_H
@@ -0,0 +1,28 @@
+/**
+ * Build configuration shared by the stringhelpers headers.
+ */
+
+#ifndef STRINGHELPERS_CONFIG_H
+#define STRINGHELPERS_CONFIG_H
+
+#include <cstdlib>
+
+/**
+ * Whether the headers are compiled with exception support. Without it (for example with
+ * '-fno-exceptions'), every error that would throw aborts instead; use the 'strh::nx' functions
+ * to handle errors without exceptions.
+ */
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define STRINGHELPERS_EXCEPTIONS 1
+#else
+#define STRINGHELPERS_EXCEPTIONS 0
+#endif
+
+#if STRINGHELPERS_EXCEPTIONS
+#define STRH_THROW(exception) throw exception
+#else
+// The exception is still evaluated, so variables only used to build it are not reported unused.
+#define STRH_THROW(exception) ((void) (exception), std::abort())
+#endif
+
+#endif //STRINGHELPERS_CONFIG_H
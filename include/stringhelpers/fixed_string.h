@@ -0,0 +1,346 @@
+/**
+ * Inline fixed-capacity string.
+ */
+
+#ifndef STRINGHELPERS_FIXED_STRING_H
+#define STRINGHELPERS_FIXED_STRING_H
+
+#include <cassert>
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "stringhelpers/config.h"
+#include "stringhelpers/hash.h"
+#include "stringhelpers/stringhelpers.h"
+
+namespace strh
+{
+
+/**
+ * A string of at most 'N' characters stored inline, followed by a one byte length.
+ *
+ * Trivially copyable, so arrays of it are packed with no heap indirection; 'fixed_string<15>' is
+ * 16 bytes. Unused characters are always zero, which lets equality compare the whole object at
+ * once instead of character by character. Converts implicitly to 'std::string_view', so it can be
+ * passed to every strh function taking one.
+ *
+ * @tparam N the maximum number of characters.
+ */
+template<size_t N>
+class fixed_string
+{
+        static_assert(N > 0 && N <= UINT8_MAX, "fixed_string capacity must be between 1 and 255");
+
+public:
+        constexpr fixed_string() = default;
+
+        /**
+         * Creates a fixed_string holding 'string'.
+         *
+         * @param string the characters to copy.
+         *
+         * @throws std::length_error Thrown if 'string' is longer than 'N'.
+         */
+        constexpr fixed_string(std::string_view string)
+        {
+                assign(string);
+        }
+
+        /**
+         * Creates a fixed_string holding 'string'.
+         *
+         * @param string the null-terminated characters to copy.
+         *
+         * @throws std::length_error Thrown if 'string' is longer than 'N'.
+         */
+        constexpr fixed_string(const char *string)
+                : fixed_string(std::string_view(string))
+        {
+        }
+
+        /**
+         * Replaces the contents with 'string'.
+         *
+         * @param string the characters to copy.
+         *
+         * @throws std::length_error Thrown if 'string' is longer than 'N'.
+         */
+        constexpr void assign(std::string_view string)
+        {
+                if (string.length() > N)
+                        STRH_THROW(std::length_error("string does not fit in fixed_string"));
+
+                std::char_traits<char>::copy(data_, string.data(), string.length());
+                std::char_traits<char>::assign(data_ + string.length(), N - string.length(), '\0');
+                length_ = static_cast<uint8_t>(string.length());
+        }
+
+        /**
+         * Appends 'string'.
+         *
+         * @param string the characters to append.
+         *
+         * @return this fixed_string.
+         *
+         * @throws std::length_error Thrown if the result is longer than 'N'.
+         */
+        constexpr fixed_string &append(std::string_view string)
+        {
+                if (string.length() > N - length_)
+                        STRH_THROW(std::length_error("string does not fit in fixed_string"));
+
+                std::char_traits<char>::copy(data_ + length_, string.data(), string.length());
+                length_ += static_cast<uint8_t>(string.length());
+                return *this;
+        }
+
+        /**
+         * Appends 'ch'.
+         *
+         * @param ch the character to append.
+         *
+         * @throws std::length_error Thrown if the fixed_string is full.
+         */
+        constexpr void push_back(char ch)
+        {
+                append(std::string_view(&ch, 1));
+        }
+
+        /**
+         * Changes the length to 'length', zeroing characters past it.
+         *
+         * @param length the new length.
+         *
+         * @throws std::length_error Thrown if 'length' is larger than 'N'.
+         */
+        constexpr void resize(size_t length)
+        {
+                if (length > N)
+                        STRH_THROW(std::length_error("length does not fit in fixed_string"));
+
+                if (length < length_)
+                        std::char_traits<char>::assign(data_ + length, length_ - length, '\0');
+                length_ = static_cast<uint8_t>(length);
+        }
+
+        constexpr const char *data() const
+        {
+                return data_;
+        }
+
+        constexpr size_t length() const
+        {
+                return length_;
+        }
+
+        constexpr size_t size() const
+        {
+                return length_;
+        }
+
+        constexpr bool empty() const
+        {
+                return length_ == 0;
+        }
+
+        static constexpr size_t capacity()
+        {
+                return N;
+        }
+
+        /**
+         * @return the character at 'idx', for writing.
+         *
+         * @note 'idx' must be less than 'length()': the unused characters must stay zero for
+         * equality, so grow the string with 'resize' first.
+         */
+        constexpr char &operator[](size_t idx)
+        {
+                assert(idx < length_);
+                return data_[idx];
+        }
+
+        /**
+         * @return the character at 'idx', for writing.
+         *
+         * @throws std::out_of_range Thrown if 'idx' is not less than 'length()'.
+         */
+        constexpr char &at(size_t idx)
+        {
+                if (idx >= length_)
+                        STRH_THROW(std::out_of_range("index past the end of fixed_string"));
+                return data_[idx];
+        }
+
+        constexpr const char &operator[](size_t idx) const
+        {
+                return data_[idx];
+        }
+
+        constexpr char *begin()
+        {
+                return data_;
+        }
+
+        constexpr char *end()
+        {
+                return data_ + length_;
+        }
+
+        constexpr const char *begin() const
+        {
+                return data_;
+        }
+
+        constexpr const char *end() const
+        {
+                return data_ + length_;
+        }
+
+        constexpr operator std::string_view() const
+        {
+                return {data_, length_};
+        }
+
+        /**
+         * @return a copy of the characters as a 'std::string'.
+         */
+        std::string str() const
+        {
+                return {data_, length_};
+        }
+
+        /**
+         * Compares every byte at once; unused characters are always zero.
+         */
+        friend bool operator==(const fixed_string &lhs, const fixed_string &rhs)
+        {
+                return std::memcmp(&lhs, &rhs, sizeof(fixed_string)) == 0;
+        }
+
+        friend bool operator==(const fixed_string &lhs, std::string_view rhs)
+        {
+                return std::string_view(lhs) == rhs;
+        }
+
+        friend bool operator==(const fixed_string &lhs, const char *rhs)
+        {
+                return std::string_view(lhs) == rhs;
+        }
+
+        friend std::strong_ordering operator<=>(const fixed_string &lhs, const fixed_string &rhs)
+        {
+                return std::string_view(lhs) <=> std::string_view(rhs);
+        }
+
+        friend std::strong_ordering operator<=>(const fixed_string &lhs, std::string_view rhs)
+        {
+                return std::string_view(lhs) <=> rhs;
+        }
+
+private:
+        char data_[N]{};
+        uint8_t length_ = 0;
+};
+
+/**
+ * Capitalizes 'string'.
+ *
+ * @see capitalize(std::string)
+ */
+template<size_t N>
+inline fixed_string<N> capitalize(fixed_string<N> string)
+{
+        if (!string.empty())
+                string[0] = static_cast<char>(toupper(string[0]));
+        return string;
+}
+
+/**
+ * Removes whitespaces at the beginning and end of 'string'.
+ *
+ * @see strip(std::string)
+ */
+template<size_t N>
+inline fixed_string<N> strip(const fixed_string<N> &string)
+{
+        std::string_view view = string;
+        size_t front_whitespaces_end_idx = view.find_first_not_of(" \t\n");
+        if (front_whitespaces_end_idx == std::string_view::npos)
+                return {};
+
+        size_t end_whitespaces_start_idx = view.find_last_not_of(" \t\n");
+        return fixed_string<N>(view.substr(front_whitespaces_end_idx,
+                                           end_whitespaces_start_idx - front_whitespaces_end_idx + 1));
+}
+
+/**
+ * Swaps the cases of each of character in 'string'.
+ *
+ * @see swap_cases(std::string)
+ */
+template<size_t N>
+inline fixed_string<N> swap_cases(fixed_string<N> string)
+{
+        for (char &ch: string)
+        {
+                if (isupper(ch))
+                        ch = static_cast<char>(tolower(ch));
+                else if (islower(ch))
+                        ch = static_cast<char>(toupper(ch));
+        }
+        return string;
+}
+
+/**
+ * Removes all numbers in 'string'.
+ *
+ * @see remove_nums(std::string)
+ */
+template<size_t N>
+inline fixed_string<N> remove_nums(fixed_string<N> string)
+{
+        size_t kept = 0;
+        for (char ch: string)
+        {
+                if (!isdigit(ch))
+                        string[kept++] = ch;
+        }
+        string.resize(kept);
+        return string;
+}
+
+/**
+ * Removes all alphabetical (letters) in 'string'.
+ *
+ * @see remove_alphabetical(std::string)
+ */
+template<size_t N>
+inline fixed_string<N> remove_alphabetical(fixed_string<N> string)
+{
+        size_t kept = 0;
+        for (char ch: string)
+        {
+                if (!isalpha(ch))
+                        string[kept++] = ch;
+        }
+        string.resize(kept);
+        return string;
+}
+}
+
+template<size_t N>
+struct std::hash<strh::fixed_string<N>>
+{
+        size_t operator()(const strh::fixed_string<N> &string) const noexcept
+        {
+                return strh::hash(string);
+        }
+};
+
+#endif //STRINGHELPERS_FIXED_STRING_H
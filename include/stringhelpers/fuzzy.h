@@ -0,0 +1,303 @@
+/**
+ * Edit distances and nearest-string search with Myers' bit-parallel algorithm.
+ */
+
+#ifndef STRINGHELPERS_FUZZY_H
+#define STRINGHELPERS_FUZZY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "stringhelpers/stringhelpers.h"
+
+namespace strh
+{
+
+/**
+ * Helper functions for the edit distances.
+ *
+ * @relatealso strh
+ */
+namespace priv_helpers
+{
+
+/**
+ * Advances one block of 64 rows of the edit distance matrix by one column.
+ *
+ * 'pv' and 'mv' hold the vertical deltas of the block, +1 and -1 respectively, and 'eq' the rows
+ * whose pattern character matches the text character of the column. 'hin' is the horizontal delta
+ * entering the block from the row above it.
+ *
+ * @return the horizontal delta at row 'last' of the block.
+ */
+inline int myers_advance(uint64_t &pv, uint64_t &mv, uint64_t eq, int hin, uint64_t last)
+{
+        uint64_t hin_negative = hin < 0;
+        uint64_t xv = eq | mv;
+        eq |= hin_negative;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        int hout = (ph & last) != 0 ? 1 : (mh & last) != 0 ? -1 : 0;
+        ph = ph << 1 | static_cast<uint64_t>(hin > 0);
+        mh = mh << 1 | hin_negative;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+        return hout;
+}
+
+/**
+ * Returns the edit distance between a pattern of 'length' characters and 'text', or 'max + 1' as
+ * soon as it is known to be over 'max'.
+ *
+ * @param peq the match masks of the pattern, 'blocks' words per character.
+ * @param scratch room for '2 * blocks' words, used when 'blocks' is over 1.
+ */
+inline size_t myers_distance(const uint64_t *peq, size_t blocks, size_t length, std::string_view text,
+                             size_t max, uint64_t *scratch)
+{
+        if (length == 0)
+                return text.length() > max ? max + 1 : text.length();
+
+        // The last row can drop by at most one per remaining column, so the distance is over 'max'
+        // once the last row minus the columns left is.
+        size_t score = length;
+        size_t left = text.length();
+        uint64_t last = 1ULL << ((length - 1) % 64);
+        if (blocks == 1)
+        {
+                uint64_t pv = ~0ULL;
+                uint64_t mv = 0;
+                for (unsigned char ch: text)
+                {
+                        score += myers_advance(pv, mv, peq[ch], 1, last);
+                        if (score > --left && score - left > max)
+                                return max + 1;
+                }
+                return score;
+        }
+
+        uint64_t *pv = scratch;
+        uint64_t *mv = scratch + blocks;
+        std::fill(pv, pv + blocks, ~0ULL);
+        std::fill(mv, mv + blocks, 0);
+        for (unsigned char ch: text)
+        {
+                const uint64_t *eq = peq + ch * blocks;
+                int h = 1;
+                for (size_t b = 0; b + 1 < blocks; b++)
+                        h = myers_advance(pv[b], mv[b], eq[b], h, 1ULL << 63);
+                score += myers_advance(pv[blocks - 1], mv[blocks - 1], eq[blocks - 1], h, last);
+                if (score > --left && score - left > max)
+                        return max + 1;
+        }
+        return score;
+}
+
+/**
+ * Returns the edit distance between 'a' and 'b', or 'max + 1' if it is over 'max'.
+ */
+inline size_t bounded_edit_distance(std::string_view a, std::string_view b, size_t max)
+{
+        if (a.length() > b.length())
+                std::swap(a, b);
+        if (b.length() - a.length() > max)
+                return max + 1;
+
+        if (a.length() <= 64)
+        {
+                // Only the entries of characters in 'a' or 'b' are ever read, so only those are
+                // cleared instead of the whole table.
+                uint64_t peq[256];
+                for (unsigned char ch: a)
+                        peq[ch] = 0;
+                for (unsigned char ch: b)
+                        peq[ch] = 0;
+                for (size_t i = 0; i < a.length(); i++)
+                        peq[static_cast<unsigned char>(a[i])] |= 1ULL << i;
+                return myers_distance(peq, 1, a.length(), b, max, nullptr);
+        }
+
+        // The match masks, followed by the scratch space of the vertical deltas.
+        size_t blocks = (a.length() + 63) / 64;
+        std::vector<uint64_t> peq(258 * blocks);
+        for (size_t i = 0; i < a.length(); i++)
+                peq[static_cast<unsigned char>(a[i]) * blocks + i / 64] |= 1ULL << (i % 64);
+        return myers_distance(peq.data(), blocks, a.length(), b, max, peq.data() + 256 * blocks);
+}
+}
+
+/**
+ * Calculates the Levenshtein distance between 'a' and 'b': the fewest single character
+ * insertions, deletions and substitutions turning one into the other.
+ *
+ * Uses Myers' bit-parallel algorithm, which advances 64 rows of the distance matrix per word
+ * operation, with the shorter string as the rows.
+ *
+ * @param a the first string.
+ * @param b the second string.
+ *
+ * @return the edit distance between 'a' and 'b'.
+ *
+ * @note Allocates only when both strings are longer than 64 characters.
+ */
+inline size_t edit_distance(std::string_view a, std::string_view b)
+{
+        STRH_INSTRUMENT(edit_distance, a.length() + b.length());
+        return priv_helpers::bounded_edit_distance(a, b, std::max(a.length(), b.length()));
+}
+
+/**
+ * Checks if the edit distance between 'a' and 'b' is at most 'max'.
+ *
+ * Stops as soon as the distance cannot end up at most 'max', which makes it much faster than
+ * 'edit_distance' for strings that are far apart.
+ *
+ * @param a the first string.
+ * @param b the second string.
+ * @param max the largest distance accepted.
+ *
+ * @return whether 'edit_distance(a, b) <= max'.
+ *
+ * @see edit_distance
+ */
+inline bool within_distance(std::string_view a, std::string_view b, size_t max)
+{
+        STRH_INSTRUMENT(within_distance, a.length() + b.length());
+        return priv_helpers::bounded_edit_distance(a, b, max) <= max;
+}
+
+/**
+ * A string compiled for repeated edit distances against many others.
+ *
+ * The match masks of the pattern, and the scratch space of patterns over 64 characters, are built
+ * once, so each distance costs only the bit-parallel pass over the other string.
+ *
+ * @note A fuzzy_pattern over 64 characters writes to its scratch space on every distance, so it
+ * must not be used by several threads at once.
+ */
+class fuzzy_pattern
+{
+public:
+        /**
+         * @param pattern the string to compare others against.
+         */
+        explicit fuzzy_pattern(std::string_view pattern)
+                : length_(pattern.length()), blocks_(std::max<size_t>(1, (pattern.length() + 63) / 64)),
+                  peq_(256 * blocks_), scratch_(blocks_ > 1 ? 2 * blocks_ : 0)
+        {
+                for (size_t i = 0; i < pattern.length(); i++)
+                        peq_[static_cast<unsigned char>(pattern[i]) * blocks_ + i / 64] |= 1ULL << (i % 64);
+        }
+
+        size_t length() const
+        {
+                return length_;
+        }
+
+        /**
+         * @return the edit distance between the pattern and 'text'.
+         */
+        size_t distance(std::string_view text) const
+        {
+                size_t max = std::max(length_, text.length());
+                return priv_helpers::myers_distance(peq_.data(), blocks_, length_, text, max, scratch_.data());
+        }
+
+        /**
+         * @return the edit distance between the pattern and 'text', or 'max + 1' if it is over 'max'.
+         */
+        size_t distance(std::string_view text, size_t max) const
+        {
+                size_t difference = std::max(length_, text.length()) - std::min(length_, text.length());
+                if (difference > max)
+                        return max + 1;
+                return priv_helpers::myers_distance(peq_.data(), blocks_, length_, text, max,
+                                                    scratch_.data());
+        }
+
+private:
+        size_t length_;
+        size_t blocks_;
+        std::vector<uint64_t> peq_;
+        mutable std::vector<uint64_t> scratch_;
+};
+
+/**
+ * A string found by 'nearest'.
+ */
+struct fuzzy_match
+{
+        /** The position of the string in the searched strings. */
+        size_t index;
+        /** The edit distance between the string and the query. */
+        size_t distance;
+
+        bool operator==(const fuzzy_match &) const = default;
+};
+
+/**
+ * Finds the 'k' strings of 'strings' with the smallest edit distance to 'query'.
+ *
+ * 'query' is compiled once for the whole search, so nothing is allocated per string. Each string
+ * is first rejected on its length alone when it cannot beat the current 'k'th best, and otherwise
+ * compared with the distance bounded by it, so most strings of a large set are abandoned after a
+ * few columns.
+ *
+ * @tparam Range a range of strings convertible to 'std::string_view', such as a
+ * 'std::vector<std::string>' or a 'string_column'.
+ *
+ * @param query the string to search for.
+ * @param strings the strings to search.
+ * @param k the most matches to return.
+ * @param max_distance the largest distance of a match. (default no limit)
+ *
+ * @return the matches sorted by distance, ties by index.
+ */
+template<typename Range>
+inline std::vector<fuzzy_match> nearest(std::string_view query, const Range &strings, size_t k,
+                                        size_t max_distance = std::string_view::npos)
+{
+        STRH_INSTRUMENT(nearest, query.length());
+        std::vector<fuzzy_match> ret;
+        if (k == 0)
+                return ret;
+
+        ret.reserve(k + 1);
+        fuzzy_pattern pattern(query);
+        auto by_distance = [](const fuzzy_match &lhs, const fuzzy_match &rhs) {
+                return lhs.distance != rhs.distance ? lhs.distance < rhs.distance : lhs.index < rhs.index;
+        };
+
+        // 'ret' is a max-heap of the best matches so far; once full, a string must beat its top.
+        size_t limit = max_distance;
+        size_t index = 0;
+        for (const auto &string: strings)
+        {
+                size_t distance = pattern.distance(std::string_view(string), limit);
+                if (distance <= limit)
+                {
+                        ret.push_back({index, distance});
+                        std::push_heap(ret.begin(), ret.end(), by_distance);
+                        if (ret.size() > k)
+                        {
+                                std::pop_heap(ret.begin(), ret.end(), by_distance);
+                                ret.pop_back();
+                        }
+                        if (ret.size() == k)
+                        {
+                                if (ret.front().distance == 0)
+                                        break;
+                                limit = ret.front().distance - 1;
+                        }
+                }
+                index++;
+        }
+        std::sort_heap(ret.begin(), ret.end(), by_distance);
+        return ret;
+}
+}
+
+#endif //STRINGHELPERS_FUZZY_H
@@ -0,0 +1,365 @@
+/**
+ * Wildcard patterns compiled once and matched against many strings.
+ */
+
+#ifndef STRINGHELPERS_GLOB_H
+#define STRINGHELPERS_GLOB_H
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "stringhelpers/hash.h"
+#include "stringhelpers/stringhelpers.h"
+
+namespace strh
+{
+
+class glob_set;
+
+/**
+ * A wildcard pattern such as 'ES*.CME' or '?NQ*', where '*' matches any run of characters,
+ * including none, and '?' matches exactly one character. Every other character matches itself.
+ *
+ * The pattern is split once at its '*'s into pieces. The first piece must start the string and the
+ * last must end it, which 'starts_with' and 'ends_with' check, and the pieces in between are found
+ * left to right, each at its first occurrence after the previous one. Taking the first occurrence
+ * never misses a match, so matching is linear in the string, without backtracking.
+ */
+class glob
+{
+public:
+        /**
+         * @param pattern the pattern to compile.
+         */
+        explicit glob(std::string_view pattern)
+                : pattern_(pattern)
+        {
+                size_t start = 0;
+                size_t star;
+                while ((star = pattern.find('*', start)) != std::string_view::npos)
+                {
+                        add_piece(start, star);
+                        start = star + 1;
+                }
+                add_piece(start, pattern.length());
+        }
+
+        /**
+         * Checks if 'string' matches the pattern.
+         *
+         * @param string the string to check.
+         *
+         * @return whether the whole of 'string' matches the pattern.
+         */
+        bool matches(std::string_view string) const
+        {
+                STRH_INSTRUMENT(glob, string.length());
+                return match(string);
+        }
+
+        /**
+         * @return the pattern the glob was compiled from.
+         */
+        std::string_view pattern() const
+        {
+                return pattern_;
+        }
+
+        /**
+         * @return the fewest characters a matching string has.
+         */
+        size_t min_length() const
+        {
+                return min_length_;
+        }
+
+        /**
+         * @return whether the pattern has no wildcards, so only the pattern itself matches.
+         */
+        bool is_literal() const
+        {
+                return !has_star_ && !pieces_[0].wildcard;
+        }
+
+private:
+        friend class glob_set;
+
+        /**
+         * The characters of the pattern between two '*'s. A piece with '?'s is searched for by its
+         * longest run of literal characters, the anchor, and then compared in full.
+         */
+        struct piece
+        {
+                size_t start;
+                size_t length;
+                bool wildcard = false;
+                size_t anchor_start = 0;
+                size_t anchor_length = 0;
+        };
+
+        void add_piece(size_t start, size_t end)
+        {
+                piece added{start, end - start};
+                for (size_t pos = start; pos < end;)
+                {
+                        size_t run_end = pos;
+                        while (run_end < end && pattern_[run_end] != '?')
+                                run_end++;
+                        if (run_end - pos > added.anchor_length)
+                        {
+                                added.anchor_start = pos - start;
+                                added.anchor_length = run_end - pos;
+                        }
+                        if (run_end < end)
+                                added.wildcard = true;
+                        pos = run_end + 1;
+                }
+
+                // Empty pieces between two '*'s match anywhere and are dropped.
+                if (!pieces_.empty() && added.length == 0 && start != pattern_.length())
+                        return;
+                if (!pieces_.empty())
+                        has_star_ = true;
+                min_length_ += added.length;
+                pieces_.push_back(added);
+        }
+
+        std::string_view text(const piece &matched) const
+        {
+                return std::string_view(pattern_).substr(matched.start, matched.length);
+        }
+
+        bool equals(const piece &matched, const char *data) const
+        {
+                const char *text = pattern_.data() + matched.start;
+                if (!matched.wildcard)
+                        return std::memcmp(text, data, matched.length) == 0;
+                for (size_t i = 0; i < matched.length; i++)
+                {
+                        if (text[i] != '?' && text[i] != data[i])
+                                return false;
+                }
+                return true;
+        }
+
+        /**
+         * Returns the first index at or after 'pos' where 'matched' occurs in 'string', or
+         * 'std::string_view::npos'.
+         */
+        size_t find_piece(const piece &matched, std::string_view string, size_t pos) const
+        {
+                if (!matched.wildcard)
+                        return string.find(text(matched), pos);
+
+                std::string_view anchor = text(matched).substr(matched.anchor_start, matched.anchor_length);
+                if (anchor.empty())
+                        return pos + matched.length <= string.length() ? pos : std::string_view::npos;
+                for (size_t at = string.find(anchor, pos + matched.anchor_start); at != std::string_view::npos;
+                     at = string.find(anchor, at + 1))
+                {
+                        size_t start = at - matched.anchor_start;
+                        if (start + matched.length > string.length())
+                                return std::string_view::npos;
+                        if (equals(matched, string.data() + start))
+                                return start;
+                }
+                return std::string_view::npos;
+        }
+
+        bool match(std::string_view string) const
+        {
+                const piece &first = pieces_.front();
+                if (!has_star_)
+                        return string.length() == first.length && equals(first, string.data());
+                if (string.length() < min_length_)
+                        return false;
+
+                const piece &last = pieces_.back();
+                if (first.wildcard ? !equals(first, string.data()) : !starts_with(string, text(first)))
+                        return false;
+                if (last.wildcard ? !equals(last, string.data() + string.length() - last.length)
+                                  : !ends_with(string, text(last)))
+                        return false;
+
+                std::string_view middle = string.substr(0, string.length() - last.length);
+                size_t pos = first.length;
+                for (size_t i = 1; i + 1 < pieces_.size(); i++)
+                {
+                        size_t found = find_piece(pieces_[i], middle, pos);
+                        if (found == std::string_view::npos)
+                                return false;
+                        pos = found + pieces_[i].length;
+                }
+                return true;
+        }
+
+        std::string pattern_;
+        /** The pieces between '*'s; with a '*', the first and last are anchored to the ends. */
+        std::vector<piece> pieces_;
+        size_t min_length_ = 0;
+        bool has_star_ = false;
+};
+
+/**
+ * A set of globs matched against one string at once, such as the subscriptions of every client.
+ *
+ * Patterns without wildcards are looked up in a hash map. The others are bucketed by one literal
+ * character at a fixed position: one of the first few characters of the string or, for patterns
+ * starting with '*', one of the last few. A string is then only compared with the patterns of the
+ * buckets of its own characters, so matching costs grow with the patterns sharing those
+ * characters instead of with the whole set.
+ */
+class glob_set
+{
+public:
+        /**
+         * Adds a pattern to the set.
+         *
+         * @param pattern the pattern to add.
+         *
+         * @return the id of the pattern: '0' for the first pattern added, '1' for the next, and so on.
+         */
+        size_t add(std::string_view pattern)
+        {
+                size_t id = globs_.size();
+                globs_.emplace_back(pattern);
+                const glob &added = globs_.back();
+                if (added.is_literal())
+                {
+                        literals_[std::string(pattern)].push_back(id);
+                        return id;
+                }
+
+                std::string_view first = added.text(added.pieces_.front());
+                std::string_view last = added.text(added.pieces_.back());
+                for (size_t pos = 0; pos < key_positions; pos++)
+                {
+                        if (pos < first.length() && first[pos] != '?')
+                        {
+                                front_[pos][static_cast<unsigned char>(first[pos])].push_back(id);
+                                return id;
+                        }
+                        if (pos < last.length() && last[last.length() - 1 - pos] != '?')
+                        {
+                                back_[pos][static_cast<unsigned char>(last[last.length() - 1 - pos])].push_back(id);
+                                return id;
+                        }
+                }
+                unkeyed_.push_back(id);
+                return id;
+        }
+
+        /**
+         * @return the pattern with id 'id'.
+         */
+        const glob &operator[](size_t id) const
+        {
+                return globs_[id];
+        }
+
+        size_t size() const
+        {
+                return globs_.size();
+        }
+
+        /**
+         * Calls 'callback' with the id of every pattern 'string' matches, in no particular order.
+         *
+         * @tparam F a callable taking a 'size_t'.
+         *
+         * @param string the string to match.
+         * @param callback the function to call with each id.
+         */
+        template<typename F>
+        void for_each_match(std::string_view string, F &&callback) const
+        {
+                STRH_INSTRUMENT(glob, string.length());
+                for_each_candidate(string, [&](size_t id) {
+                        if (globs_[id].match(string))
+                                callback(id);
+                        return false;
+                });
+        }
+
+        /**
+         * Finds the patterns 'string' matches.
+         *
+         * @param string the string to match.
+         *
+         * @return the ids of the matching patterns, in ascending order.
+         */
+        std::vector<size_t> matches(std::string_view string) const
+        {
+                std::vector<size_t> ret;
+                for_each_match(string, [&](size_t id) { ret.push_back(id); });
+                std::sort(ret.begin(), ret.end());
+                return ret;
+        }
+
+        /**
+         * @return whether 'string' matches any pattern of the set.
+         */
+        bool matches_any(std::string_view string) const
+        {
+                STRH_INSTRUMENT(glob, string.length());
+                return for_each_candidate(string, [&](size_t id) { return globs_[id].match(string); });
+        }
+
+private:
+        /** How many characters from either end of a string are used as bucket keys. */
+        static constexpr size_t key_positions = 4;
+
+        using bucket_table = std::array<std::array<std::vector<size_t>, 256>, key_positions>;
+
+        /**
+         * Calls 'visit' with every pattern 'string' may match, and with the patterns matching it
+         * exactly, until 'visit' returns 'true'.
+         *
+         * @return whether 'visit' returned 'true'.
+         */
+        template<typename F>
+        bool for_each_candidate(std::string_view string, F &&visit) const
+        {
+                auto literal = literals_.find(string);
+                if (literal != literals_.end())
+                {
+                        for (size_t id: literal->second)
+                        {
+                                if (visit(id))
+                                        return true;
+                        }
+                }
+
+                for (size_t pos = 0; pos < key_positions && pos < string.length(); pos++)
+                {
+                        for (size_t id: front_[pos][static_cast<unsigned char>(string[pos])])
+                        {
+                                if (visit(id))
+                                        return true;
+                        }
+                        for (size_t id: back_[pos][static_cast<unsigned char>(string[string.length() - 1 - pos])])
+                        {
+                                if (visit(id))
+                                        return true;
+                        }
+                }
+                return std::any_of(unkeyed_.begin(), unkeyed_.end(), visit);
+        }
+
+        std::vector<glob> globs_;
+        std::unordered_map<std::string, std::vector<size_t>, hasher, std::equal_to<>> literals_;
+        /** Patterns by their character at a position from the start of the string. */
+        bucket_table front_;
+        /** Patterns by their character at a position from the end of the string. */
+        bucket_table back_;
+        std::vector<size_t> unkeyed_;
+};
+}
+
+#endif //STRINGHELPERS_GLOB_H
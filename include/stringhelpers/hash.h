@@ -0,0 +1,251 @@
+/**
+ * Fast non-cryptographic string hashing.
+ */
+
+#ifndef STRINGHELPERS_HASH_H
+#define STRINGHELPERS_HASH_H
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace strh
+{
+
+/**
+ * Helper functions for the hashing functions.
+ *
+ * @relatealso strh
+ */
+namespace priv_helpers
+{
+
+/**
+ * Multiplies 'a' and 'b' to 128 bits, storing the low half in 'a' and the high half in 'b'.
+ */
+inline void mul128(uint64_t &a, uint64_t &b)
+{
+#ifdef __SIZEOF_INT128__
+        __uint128_t product = static_cast<__uint128_t>(a) * b;
+        a = static_cast<uint64_t>(product);
+        b = static_cast<uint64_t>(product >> 64);
+#else
+        uint64_t a_hi = a >> 32, a_lo = static_cast<uint32_t>(a);
+        uint64_t b_hi = b >> 32, b_lo = static_cast<uint32_t>(b);
+        uint64_t hi_hi = a_hi * b_hi, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, lo_lo = a_lo * b_lo;
+        uint64_t cross = (lo_lo >> 32) + static_cast<uint32_t>(hi_lo) + lo_hi;
+        b = hi_hi + (hi_lo >> 32) + (cross >> 32);
+        a = (cross << 32) | static_cast<uint32_t>(lo_lo);
+#endif
+}
+
+/**
+ * Multiplies 'a' and 'b' to 128 bits and folds the halves together.
+ */
+inline uint64_t mum(uint64_t a, uint64_t b)
+{
+        mul128(a, b);
+        return a ^ b;
+}
+
+/**
+ * Converts the ASCII uppercase bytes of 'word' to lowercase, 8 bytes at a time.
+ */
+inline uint64_t fold_word(uint64_t word)
+{
+        constexpr uint64_t ones = 0x0101010101010101ULL;
+        uint64_t heptets = word & (0x7f * ones);
+        uint64_t above_z = heptets + (0x80 - 'Z' - 1) * ones;
+        uint64_t from_a = heptets + (0x80 - 'A') * ones;
+        uint64_t is_upper = (from_a ^ above_z) & ~word & (0x80 * ones);
+        return word | (is_upper >> 2);
+}
+
+template<bool IgnoreCase>
+inline uint64_t read64(const char *data)
+{
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        return IgnoreCase ? fold_word(word) : word;
+}
+
+template<bool IgnoreCase>
+inline uint64_t read32(const char *data)
+{
+        uint32_t word;
+        std::memcpy(&word, data, sizeof(word));
+        return IgnoreCase ? fold_word(word) : word;
+}
+
+/**
+ * wyhash (final version 4), optionally folding ASCII case as bytes are read.
+ */
+template<bool IgnoreCase>
+inline uint64_t wyhash(std::string_view string, uint64_t seed)
+{
+        constexpr uint64_t p0 = 0xa0761d6478bd642fULL;
+        constexpr uint64_t p1 = 0xe7037ed1a0b428dbULL;
+        constexpr uint64_t p2 = 0x8ebc6af09c88c6e3ULL;
+        constexpr uint64_t p3 = 0x589965cc75374cc3ULL;
+
+        const char *data = string.data();
+        size_t len = string.length();
+        seed ^= mum(seed ^ p0, p1);
+
+        uint64_t a, b;
+        if (len <= 16)
+        {
+                if (len >= 4)
+                {
+                        size_t shift = (len >> 3) << 2;
+                        a = (read32<IgnoreCase>(data) << 32) | read32<IgnoreCase>(data + shift);
+                        b = (read32<IgnoreCase>(data + len - 4) << 32)
+                            | read32<IgnoreCase>(data + len - 4 - shift);
+                }
+                else if (len > 0)
+                {
+                        uint64_t word = (uint64_t(static_cast<unsigned char>(data[0])) << 16)
+                                        | (uint64_t(static_cast<unsigned char>(data[len >> 1])) << 8)
+                                        | static_cast<unsigned char>(data[len - 1]);
+                        a = IgnoreCase ? fold_word(word) : word;
+                        b = 0;
+                }
+                else
+                {
+                        a = b = 0;
+                }
+        }
+        else
+        {
+                size_t remaining = len;
+                if (remaining > 48)
+                {
+                        uint64_t see1 = seed, see2 = seed;
+                        do
+                        {
+                                seed = mum(read64<IgnoreCase>(data) ^ p1, read64<IgnoreCase>(data + 8) ^ seed);
+                                see1 = mum(read64<IgnoreCase>(data + 16) ^ p2, read64<IgnoreCase>(data + 24) ^ see1);
+                                see2 = mum(read64<IgnoreCase>(data + 32) ^ p3, read64<IgnoreCase>(data + 40) ^ see2);
+                                data += 48;
+                                remaining -= 48;
+                        } while (remaining > 48);
+                        seed ^= see1 ^ see2;
+                }
+                while (remaining > 16)
+                {
+                        seed = mum(read64<IgnoreCase>(data) ^ p1, read64<IgnoreCase>(data + 8) ^ seed);
+                        data += 16;
+                        remaining -= 16;
+                }
+                a = read64<IgnoreCase>(data + remaining - 16);
+                b = read64<IgnoreCase>(data + remaining - 8);
+        }
+
+        a ^= p1;
+        b ^= seed;
+        mul128(a, b);
+        return mum(a ^ p0 ^ len, b ^ p1);
+}
+}
+
+/**
+ * Hashes 'string'.
+ *
+ * Uses wyhash, which is several times faster than typical 'std::hash<std::string_view>'
+ * implementations on short keys and mixes every input bit into every output bit.
+ *
+ * @param string the string to hash.
+ * @param seed the seed to hash with.
+ *
+ * @return the 64-bit hash of 'string'.
+ */
+inline uint64_t hash(std::string_view string, uint64_t seed = 0)
+{
+        return priv_helpers::wyhash<false>(string, seed);
+}
+
+/**
+ * Hashes 'string' ignoring ASCII case.
+ *
+ * @param string the string to hash.
+ * @param seed the seed to hash with.
+ *
+ * @return the 64-bit hash of 'string', equal for strings that only differ in ASCII case.
+ */
+inline uint64_t hash_ignore_case(std::string_view string, uint64_t seed = 0)
+{
+        return priv_helpers::wyhash<true>(string, seed);
+}
+
+/**
+ * Checks if 'lhs' and 'rhs' are equal ignoring ASCII case.
+ *
+ * @param lhs the first string to compare.
+ * @param rhs the second string to compare.
+ *
+ * @return 'true' if 'lhs' and 'rhs' only differ in ASCII case, 'false' otherwise.
+ */
+inline bool equals_ignore_case(std::string_view lhs, std::string_view rhs)
+{
+        if (lhs.length() != rhs.length())
+                return false;
+
+        size_t idx = 0;
+        for (; idx + 8 <= lhs.length(); idx += 8)
+        {
+                if (priv_helpers::read64<true>(lhs.data() + idx) != priv_helpers::read64<true>(rhs.data() + idx))
+                        return false;
+        }
+        for (; idx < lhs.length(); idx++)
+        {
+                if (priv_helpers::fold_word(static_cast<unsigned char>(lhs[idx]))
+                    != priv_helpers::fold_word(static_cast<unsigned char>(rhs[idx])))
+                        return false;
+        }
+        return true;
+}
+
+/**
+ * Transparent hash functor for unordered containers keyed on strings.
+ *
+ * Use with 'std::equal_to<>' to look up 'std::string' keys by 'std::string_view' or 'const char *'
+ * without constructing a key.
+ */
+struct hasher
+{
+        using is_transparent = void;
+
+        size_t operator()(std::string_view string) const noexcept
+        {
+                return strh::hash(string);
+        }
+};
+
+/**
+ * Transparent hash functor ignoring ASCII case. Use with 'iequal'.
+ */
+struct ihash
+{
+        using is_transparent = void;
+
+        size_t operator()(std::string_view string) const noexcept
+        {
+                return strh::hash_ignore_case(string);
+        }
+};
+
+/**
+ * Transparent equality functor ignoring ASCII case. Use with 'ihash'.
+ */
+struct iequal
+{
+        using is_transparent = void;
+
+        bool operator()(std::string_view lhs, std::string_view rhs) const noexcept
+        {
+                return strh::equals_ignore_case(lhs, rhs);
+        }
+};
+}
+
+#endif //STRINGHELPERS_HASH_H
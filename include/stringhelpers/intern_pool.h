@@ -0,0 +1,276 @@
+/**
+ * String interning.
+ */
+
+#ifndef STRINGHELPERS_INTERN_POOL_H
+#define STRINGHELPERS_INTERN_POOL_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "stringhelpers/config.h"
+#include "stringhelpers/hash.h"
+
+namespace strh
+{
+
+/**
+ * Maps strings to dense 32-bit ids.
+ *
+ * The first string interned gets id '0', the next new string id '1', and so on. Interned bytes are
+ * copied into an arena and never move, so views returned by 'view' stay valid for the lifetime of
+ * the pool.
+ *
+ * 'find' and 'view' never lock and may run on any number of threads while other threads call
+ * 'intern'. Inserts lock one of several shards, picked by hash, so inserts of different strings
+ * rarely contend.
+ */
+class intern_pool
+{
+public:
+        using id_type = uint32_t;
+
+        /** Returned by 'find' when a string has not been interned. */
+        static constexpr id_type npos = UINT32_MAX;
+
+        intern_pool() = default;
+        intern_pool(const intern_pool &) = delete;
+        intern_pool &operator=(const intern_pool &) = delete;
+
+        ~intern_pool()
+        {
+                for (std::atomic<entry *> &segment : segments_)
+                        delete[] segment.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Interns 'string'.
+         *
+         * @param string the string to intern.
+         *
+         * @return the id of 'string', allocating a new id if 'string' was not interned before.
+         *
+         * @throws std::length_error Thrown if the pool already holds 'npos' strings.
+         */
+        id_type intern(std::string_view string)
+        {
+                uint64_t hash = strh::hash(string);
+                shard &owner = shards_[hash >> (64 - shard_bits)];
+
+                id_type id = lookup(owner.current.load(std::memory_order_acquire), string, hash);
+                if (id != npos)
+                        return id;
+
+                std::lock_guard lock(owner.mutex);
+                table *current = owner.current.load(std::memory_order_relaxed);
+                id = lookup(current, string, hash);
+                if (id != npos)
+                        return id;
+
+                if (current == nullptr || (owner.count + 1) * 2 > current->mask + 1)
+                        current = grow(owner);
+
+                uint64_t next_id = next_id_.fetch_add(1, std::memory_order_relaxed);
+                if (next_id >= npos)
+                        STRH_THROW(std::length_error("intern_pool is full"));
+                id = static_cast<id_type>(next_id);
+
+                entry &slot_entry = entry_at(id, true);
+                slot_entry.data = owner.store(string);
+                slot_entry.length = static_cast<uint32_t>(string.length());
+
+                insert(current, hash, id);
+                owner.count++;
+                return id;
+        }
+
+        /**
+         * Finds the id of 'string' without interning it.
+         *
+         * @param string the string to search for.
+         *
+         * @return the id of 'string', or 'npos' if 'string' has not been interned.
+         */
+        id_type find(std::string_view string) const
+        {
+                uint64_t hash = strh::hash(string);
+                const shard &owner = shards_[hash >> (64 - shard_bits)];
+                return lookup(owner.current.load(std::memory_order_acquire), string, hash);
+        }
+
+        /**
+         * Returns the string interned as 'id'.
+         *
+         * @param id an id returned by 'intern'.
+         *
+         * @return the interned string.
+         */
+        std::string_view view(id_type id) const
+        {
+                const entry &found = entry_at(id);
+                return {found.data, found.length};
+        }
+
+        /**
+         * @return the number of strings interned.
+         */
+        size_t size() const
+        {
+                return std::min<uint64_t>(next_id_.load(std::memory_order_acquire), npos);
+        }
+
+private:
+        struct entry
+        {
+                const char *data;
+                uint32_t length;
+        };
+
+        /**
+         * An open-addressing table of slots packing the upper hash bits with 'id + 1'. A zero
+         * slot is empty.
+         */
+        struct table
+        {
+                explicit table(size_t capacity)
+                        : mask(capacity - 1), slots(new std::atomic<uint64_t>[capacity])
+                {
+                        for (size_t i = 0; i < capacity; i++)
+                                slots[i].store(0, std::memory_order_relaxed);
+                }
+
+                size_t mask;
+                std::unique_ptr<std::atomic<uint64_t>[]> slots;
+        };
+
+        struct alignas(64) shard
+        {
+                /**
+                 * Copies 'string' into the arena.
+                 */
+                const char *store(std::string_view string)
+                {
+                        if (string.length() > arena_left)
+                        {
+                                size_t block_len = std::max(string.length(), arena_block_len);
+                                blocks.emplace_back(new char[block_len]);
+                                arena_pos = blocks.back().get();
+                                arena_left = block_len;
+                        }
+
+                        char *data = arena_pos;
+                        if (!string.empty())
+                                std::memcpy(data, string.data(), string.length());
+                        arena_pos += string.length();
+                        arena_left -= string.length();
+                        return data;
+                }
+
+                std::mutex mutex;
+                std::atomic<table *> current = nullptr;
+                // Replaced tables are kept alive because readers may still be probing them.
+                std::vector<std::unique_ptr<table>> tables;
+                size_t count = 0;
+                std::vector<std::unique_ptr<char[]>> blocks;
+                char *arena_pos = nullptr;
+                size_t arena_left = 0;
+        };
+
+        static constexpr int shard_bits = 4;
+        static constexpr size_t arena_block_len = 64 * 1024;
+        static constexpr size_t initial_table_len = 64;
+        // Segment 'i' holds '2^(first_segment_bits + i)' entries, so every 32-bit id fits in
+        // '33 - first_segment_bits' segments and existing entries never move.
+        static constexpr int first_segment_bits = 10;
+
+        id_type lookup(const table *current, std::string_view string, uint64_t hash) const
+        {
+                if (current == nullptr)
+                        return npos;
+
+                uint64_t tag = hash & 0xffffffff00000000ULL;
+                for (size_t idx = hash & current->mask;; idx = (idx + 1) & current->mask)
+                {
+                        uint64_t slot = current->slots[idx].load(std::memory_order_acquire);
+                        if (slot == 0)
+                                return npos;
+                        if ((slot & 0xffffffff00000000ULL) != tag)
+                                continue;
+
+                        id_type id = static_cast<id_type>(slot) - 1;
+                        if (view(id) == string)
+                                return id;
+                }
+        }
+
+        static void insert(table *current, uint64_t hash, id_type id)
+        {
+                size_t idx = hash & current->mask;
+                while (current->slots[idx].load(std::memory_order_relaxed) != 0)
+                        idx = (idx + 1) & current->mask;
+                current->slots[idx].store((hash & 0xffffffff00000000ULL) | (uint64_t(id) + 1),
+                                          std::memory_order_release);
+        }
+
+        /**
+         * Replaces the table of 'owner' with one twice as large. Must hold the shard's mutex.
+         */
+        table *grow(shard &owner)
+        {
+                table *old = owner.current.load(std::memory_order_relaxed);
+                size_t capacity = old == nullptr ? initial_table_len : (old->mask + 1) * 2;
+                auto bigger = std::make_unique<table>(capacity);
+
+                if (old != nullptr)
+                {
+                        for (size_t i = 0; i <= old->mask; i++)
+                        {
+                                uint64_t slot = old->slots[i].load(std::memory_order_relaxed);
+                                if (slot == 0)
+                                        continue;
+                                id_type id = static_cast<id_type>(slot) - 1;
+                                insert(bigger.get(), strh::hash(view(id)), id);
+                        }
+                }
+
+                table *published = bigger.get();
+                owner.tables.push_back(std::move(bigger));
+                owner.current.store(published, std::memory_order_release);
+                return published;
+        }
+
+        entry &entry_at(id_type id, bool allocate = false) const
+        {
+                uint64_t biased = (uint64_t(id) >> first_segment_bits) + 1;
+                int segment = std::bit_width(biased) - 1;
+                size_t offset = id - (((uint64_t(1) << segment) - 1) << first_segment_bits);
+
+                entry *entries = segments_[segment].load(std::memory_order_acquire);
+                if (entries == nullptr && allocate)
+                {
+                        auto *fresh = new entry[size_t(1) << (first_segment_bits + segment)];
+                        if (segments_[segment].compare_exchange_strong(entries, fresh,
+                                                                       std::memory_order_acq_rel))
+                                entries = fresh;
+                        else
+                                delete[] fresh;
+                }
+                return entries[offset];
+        }
+
+        std::array<shard, size_t(1) << shard_bits> shards_;
+        mutable std::array<std::atomic<entry *>, 33 - first_segment_bits> segments_{};
+        std::atomic<uint64_t> next_id_ = 0;
+};
+}
+
+#endif //STRINGHELPERS_INTERN_POOL_H
@@ -0,0 +1,227 @@
+/**
+ * Random access to the lines of a string through an index of its newlines.
+ */
+
+#ifndef STRINGHELPERS_LINE_INDEX_H
+#define STRINGHELPERS_LINE_INDEX_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "stringhelpers/config.h"
+#include "stringhelpers/stringhelpers.h"
+
+namespace strh
+{
+
+/**
+ * Helper functions for line_index.
+ *
+ * @relatealso strh
+ */
+namespace priv_helpers
+{
+
+/**
+ * Appends the positions of the '\n's of 'text' between 'begin' and 'end' to 'newlines', comparing
+ * 16 bytes at a time.
+ */
+template<typename Offset>
+inline void scan_newlines(std::string_view text, size_t begin, size_t end, std::vector<Offset> &newlines)
+{
+        const char *data = text.data();
+        size_t pos = begin;
+#if defined(__SSE2__)
+        const __m128i newline = _mm_set1_epi8('\n');
+        for (; pos + 16 <= end; pos += 16)
+        {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+                for (unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+                     mask != 0; mask &= mask - 1)
+                        newlines.push_back(static_cast<Offset>(pos + static_cast<size_t>(std::countr_zero(mask))));
+        }
+#endif
+        for (; pos < end; pos++)
+        {
+                if (data[pos] == '\n')
+                        newlines.push_back(static_cast<Offset>(pos));
+        }
+}
+}
+
+/**
+ * An index of the newlines of a string, giving the same lines 'split_lines' returns by number
+ * without copying them.
+ *
+ * The index holds one offset per line, so it is a fraction of the size of the text, and 'line'
+ * is two lookups. The index does not own the text: it keeps a view of it, which 'extend' replaces
+ * when the text grows, for example a log file mapped again after it was appended to.
+ *
+ * @tparam Offset the unsigned integer type of the offsets, which bounds the length of the text.
+ */
+template<typename Offset>
+class basic_line_index
+{
+        static_assert(std::is_unsigned_v<Offset>, "line_index offsets must be unsigned");
+
+public:
+        basic_line_index() = default;
+
+        /**
+         * Indexes the lines of 'text'.
+         *
+         * @param text the string to index, which must outlive the index or be replaced with 'extend'.
+         * @param threads the number of threads to scan 'text' with. Texts under 1 MiB per thread use
+         * fewer. (default 1)
+         *
+         * @throws std::length_error Thrown if 'text' is too long for 'Offset'.
+         */
+        explicit basic_line_index(std::string_view text, unsigned threads = 1)
+        {
+                extend(text, threads);
+        }
+
+        /**
+         * Indexes the bytes 'text' has past the previously indexed text.
+         *
+         * @param text the grown text, which must start with the previously indexed text.
+         * @param threads the number of threads to scan the new bytes with. (default 1)
+         *
+         * @throws std::invalid_argument Thrown if 'text' is shorter than the indexed text.
+         * @throws std::length_error Thrown if 'text' is too long for 'Offset'.
+         */
+        void extend(std::string_view text, unsigned threads = 1)
+        {
+                if (text.length() < text_.length())
+                        STRH_THROW(std::invalid_argument("line_index text cannot shrink"));
+                STRH_INSTRUMENT(line_index, text.length() - text_.length());
+                if (text.length() > std::numeric_limits<Offset>::max())
+                        STRH_THROW(std::length_error("line_index text does not fit its offsets"));
+
+                size_t begin = text_.length();
+                size_t chunks = std::clamp<size_t>((text.length() - begin) / min_chunk, 1, std::max(threads, 1u));
+                if (chunks == 1)
+                {
+                        priv_helpers::scan_newlines(text, begin, text.length(), newlines_);
+                }
+                else
+                {
+                        std::vector<std::vector<Offset>> found(chunks);
+                        std::vector<std::thread> workers;
+                        size_t chunk_len = (text.length() - begin + chunks - 1) / chunks;
+                        for (size_t i = 0; i < chunks; i++)
+                        {
+                                size_t start = std::min(text.length(), begin + i * chunk_len);
+                                size_t end = std::min(text.length(), start + chunk_len);
+                                workers.emplace_back([&text, &found, i, start, end] {
+                                        priv_helpers::scan_newlines(text, start, end, found[i]);
+                                });
+                        }
+                        for (std::thread &worker: workers)
+                                worker.join();
+
+                        size_t total = newlines_.size();
+                        for (const std::vector<Offset> &part: found)
+                                total += part.size();
+                        newlines_.reserve(total);
+                        for (const std::vector<Offset> &part: found)
+                                newlines_.insert(newlines_.end(), part.begin(), part.end());
+                }
+                text_ = text;
+        }
+
+        /**
+         * @return the number of lines, the size of the vector 'split_lines' returns for the text.
+         */
+        size_t size() const
+        {
+                size_t last_start = newlines_.empty() ? 0 : newlines_.back() + size_t(1);
+                return newlines_.size() + (last_start < text_.length() ? 1 : 0);
+        }
+
+        bool empty() const
+        {
+                return size() == 0;
+        }
+
+        /**
+         * @return line 'idx' of the text, without its '\n', as a view of the text.
+         */
+        std::string_view line(size_t idx) const
+        {
+                size_t start = idx == 0 ? 0 : newlines_[idx - 1] + size_t(1);
+                size_t end = idx < newlines_.size() ? newlines_[idx] : text_.length();
+                return text_.substr(start, end - start);
+        }
+
+        std::string_view operator[](size_t idx) const
+        {
+                return line(idx);
+        }
+
+        /**
+         * Finds the line holding the byte at 'offset', with a binary search of the newlines.
+         *
+         * @param offset the position of a byte in the text, less than its length. A '\n' belongs to
+         * the line it ends.
+         *
+         * @return the number of the line holding 'offset'.
+         */
+        size_t line_of(size_t offset) const
+        {
+                auto found = std::lower_bound(newlines_.begin(), newlines_.end(), offset);
+                return static_cast<size_t>(found - newlines_.begin());
+        }
+
+        /**
+         * @return the offset of the first byte of line 'idx' in the text.
+         */
+        size_t line_start(size_t idx) const
+        {
+                return idx == 0 ? 0 : newlines_[idx - 1] + size_t(1);
+        }
+
+        /**
+         * @return the positions of the '\n's of the text, in order.
+         */
+        std::span<const Offset> newlines() const
+        {
+                return newlines_;
+        }
+
+        /**
+         * @return the indexed text.
+         */
+        std::string_view text() const
+        {
+                return text_;
+        }
+
+private:
+        /** The fewest bytes worth a thread of their own. */
+        static constexpr size_t min_chunk = 1 << 20;
+
+        std::string_view text_;
+        std::vector<Offset> newlines_;
+};
+
+/** A line index with 32-bit offsets, for texts up to 4 GiB. */
+using line_index = basic_line_index<uint32_t>;
+
+/** A line index with 64-bit offsets. */
+using large_line_index = basic_line_index<uint64_t>;
+}
+
+#endif //STRINGHELPERS_LINE_INDEX_H
@@ -0,0 +1,141 @@
+/**
+ * String literals as template arguments, and compile-time splitting of them.
+ */
+
+#ifndef STRINGHELPERS_LITERAL_H
+#define STRINGHELPERS_LITERAL_H
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "stringhelpers/stringhelpers.h"
+
+namespace strh
+{
+
+/**
+ * A string literal usable as a template argument, for example 'split_array<"ES|NQ", '|'>()'.
+ *
+ * A template argument object lives for the whole program, so views of it never dangle.
+ *
+ * @tparam N the size of the literal, including its null terminator.
+ */
+template<size_t N>
+struct string_literal
+{
+        char data[N]{};
+
+        consteval string_literal(const char (&string)[N])
+        {
+                for (size_t i = 0; i < N; i++)
+                        data[i] = string[i];
+        }
+
+        constexpr size_t length() const
+        {
+                return N - 1;
+        }
+
+        constexpr std::string_view view() const
+        {
+                return {data, N - 1};
+        }
+
+        constexpr operator std::string_view() const
+        {
+                return view();
+        }
+};
+
+/**
+ * Helper functions for the compile-time splits.
+ *
+ * @relatealso strh
+ */
+namespace priv_helpers
+{
+
+/**
+ * Calls 'callback' with each substring 'split' would return, as views into 'string'.
+ */
+template<typename F>
+constexpr void for_each_split(std::string_view string, std::string_view delimiter, F &&callback)
+{
+        size_t start = 0;
+        size_t end;
+        while ((end = string.find(delimiter, start)) != std::string_view::npos)
+        {
+                callback(string.substr(start, end - start));
+                start = end + delimiter.length();
+        }
+
+        if (start < string.length())
+                callback(string.substr(start));
+}
+
+constexpr size_t split_count(std::string_view string, std::string_view delimiter)
+{
+        size_t ret = 0;
+        for_each_split(string, delimiter, [&](std::string_view) { ret++; });
+        return ret;
+}
+
+template<string_literal String, string_literal Delimiter>
+consteval auto split_array()
+{
+        static_assert(Delimiter.length() != 0, "delimiter cannot be empty");
+        std::array<std::string_view, split_count(String, Delimiter)> ret{};
+        size_t idx = 0;
+        for_each_split(String, Delimiter, [&](std::string_view token) { ret[idx++] = token; });
+        return ret;
+}
+}
+
+/**
+ * Splits 'String' into substrings separated by 'Delimiter' at compile time.
+ *
+ * @tparam String the string literal to split.
+ * @tparam Delimiter the character to split 'String' by.
+ *
+ * @return an array of the same substrings 'split' returns, as views into 'String'.
+ *
+ * @see split(std::string_view, char)
+ */
+template<string_literal String, char Delimiter>
+consteval auto split_array()
+{
+        return priv_helpers::split_array<String, string_literal<2>({Delimiter, '\0'})>();
+}
+
+/**
+ * Splits 'String' into substrings separated by 'Delimiter' at compile time.
+ *
+ * @tparam String the string literal to split.
+ * @tparam Delimiter the string literal to split 'String' by. Must not be empty.
+ *
+ * @return an array of the same substrings 'split' returns, as views into 'String'.
+ *
+ * @see split(std::string_view, std::string_view)
+ */
+template<string_literal String, string_literal Delimiter>
+consteval auto split_array()
+{
+        return priv_helpers::split_array<String, Delimiter>();
+}
+
+/**
+ * Splits 'String' into lines at compile time.
+ *
+ * @return an array of the same substrings 'split_lines' returns, as views into 'String'.
+ *
+ * @see split_lines
+ */
+template<string_literal String>
+consteval auto split_lines_array()
+{
+        return split_array<String, '\n'>();
+}
+}
+
+#endif //STRINGHELPERS_LITERAL_H
@@ -0,0 +1,243 @@
+/**
+ * Read-only memory-mapped files.
+ */
+
+#ifndef STRINGHELPERS_MAPPED_FILE_H
+#define STRINGHELPERS_MAPPED_FILE_H
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+/**
+ * Whether 'mapped_file' and the '*_in_file' functions are available. They need POSIX 'mmap';
+ * 'for_each_line' works everywhere.
+ */
+#if __has_include(<sys/mman.h>)
+#define STRINGHELPERS_HAS_MAPPED_FILE 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define STRINGHELPERS_HAS_MAPPED_FILE 0
+#endif
+
+#include "stringhelpers/config.h"
+#include "stringhelpers/stringhelpers.h"
+
+namespace strh
+{
+
+#if STRINGHELPERS_HAS_MAPPED_FILE
+/**
+ * A file mapped read-only into memory.
+ *
+ * Converts implicitly to 'std::string_view', so its contents can be passed to every strh function
+ * taking one without being read into a 'std::string'. Pages are loaded on first access and the
+ * kernel is told the file will be read sequentially.
+ */
+class mapped_file
+{
+public:
+        mapped_file() = default;
+
+        /**
+         * Maps the file at 'path'.
+         *
+         * @param path the path of the file to map.
+         * @param huge_pages whether to ask the kernel to back the mapping with huge pages. Ignored
+         * where unsupported.
+         *
+         * @throws std::system_error Thrown if the file cannot be opened or mapped.
+         */
+        explicit mapped_file(const std::string &path, bool huge_pages = false)
+        {
+                int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0)
+                        STRH_THROW(std::system_error(errno, std::generic_category(), "cannot open " + path));
+
+                struct stat info{};
+                if (::fstat(fd, &info) != 0)
+                {
+                        int error = errno;
+                        ::close(fd);
+                        STRH_THROW(std::system_error(error, std::generic_category(), "cannot stat " + path));
+                }
+
+                size_ = static_cast<size_t>(info.st_size);
+                if (size_ != 0)
+                {
+                        void *mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                        if (mapping == MAP_FAILED)
+                        {
+                                int error = errno;
+                                ::close(fd);
+                                STRH_THROW(std::system_error(error, std::generic_category(), "cannot map " + path));
+                        }
+                        data_ = static_cast<const char *>(mapping);
+
+                        ::madvise(mapping, size_, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+                        if (huge_pages)
+                                ::madvise(mapping, size_, MADV_HUGEPAGE);
+#else
+                        (void) huge_pages;
+#endif
+                }
+                ::close(fd);
+        }
+
+        mapped_file(const mapped_file &) = delete;
+        mapped_file &operator=(const mapped_file &) = delete;
+
+        mapped_file(mapped_file &&other) noexcept
+                : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0))
+        {
+        }
+
+        mapped_file &operator=(mapped_file &&other) noexcept
+        {
+                if (this != &other)
+                {
+                        unmap();
+                        data_ = std::exchange(other.data_, nullptr);
+                        size_ = std::exchange(other.size_, 0);
+                }
+                return *this;
+        }
+
+        ~mapped_file()
+        {
+                unmap();
+        }
+
+        const char *data() const
+        {
+                return data_;
+        }
+
+        size_t size() const
+        {
+                return size_;
+        }
+
+        bool empty() const
+        {
+                return size_ == 0;
+        }
+
+        std::string_view view() const
+        {
+                return {data_, size_};
+        }
+
+        operator std::string_view() const
+        {
+                return view();
+        }
+
+private:
+        void unmap()
+        {
+                if (data_ != nullptr)
+                        ::munmap(const_cast<char *>(data_), size_);
+                data_ = nullptr;
+                size_ = 0;
+        }
+
+        const char *data_ = nullptr;
+        size_t size_ = 0;
+};
+#endif
+
+/**
+ * Calls 'callback' with each substring of 'string' separated by '\n', without copying.
+ *
+ * Visits the same lines 'split_lines' returns.
+ *
+ * @tparam F a callable taking a 'std::string_view'.
+ *
+ * @param string the string to split.
+ * @param callback called with each line, in order.
+ *
+ * @see split_lines
+ */
+template<typename F>
+inline void for_each_line(std::string_view string, F &&callback)
+{
+        size_t start = 0;
+        while (start < string.length())
+        {
+                const void *found = std::memchr(string.data() + start, '\n', string.length() - start);
+                if (found == nullptr)
+                {
+                        callback(string.substr(start));
+                        return;
+                }
+
+                size_t end = static_cast<const char *>(found) - string.data();
+                callback(string.substr(start, end - start));
+                start = end + 1;
+        }
+}
+
+#if STRINGHELPERS_HAS_MAPPED_FILE
+/**
+ * Calls 'callback' with each line of the file at 'path', without reading the file into memory.
+ *
+ * @tparam F a callable taking a 'std::string_view'.
+ *
+ * @param path the path of the file to read.
+ * @param callback called with each line, in order.
+ *
+ * @throws std::system_error Thrown if the file cannot be opened or mapped.
+ */
+template<typename F>
+inline void for_each_line_in_file(const std::string &path, F &&callback)
+{
+        mapped_file file(path);
+        for_each_line(file.view(), std::forward<F>(callback));
+}
+
+/**
+ * Counts the number of times 'key' is in the file at 'path'.
+ *
+ * @param path the path of the file to search.
+ * @param key the string to count the occurrences of.
+ *
+ * @return the number of times 'key' is in the file.
+ *
+ * @throws std::invalid_argument Thrown if 'key' is empty.
+ * @throws std::system_error Thrown if the file cannot be opened or mapped.
+ */
+inline size_t count_in_file(const std::string &path, std::string_view key)
+{
+        mapped_file file(path);
+        return count(file.view(), key);
+}
+
+/**
+ * Finds the indexes 'key' occurs in the file at 'path'.
+ *
+ * @param path the path of the file to search.
+ * @param key the string to search for in the file.
+ *
+ * @return a vector of the byte offsets 'key' occurred at in the file.
+ *
+ * @throws std::invalid_argument Thrown if 'key' is empty.
+ * @throws std::system_error Thrown if the file cannot be opened or mapped.
+ */
+inline std::vector<size_t> find_in_file(const std::string &path, std::string_view key)
+{
+        mapped_file file(path);
+        return find(file.view(), key);
+}
+#endif
+}
+
+#endif //STRINGHELPERS_MAPPED_FILE_H
@@ -0,0 +1,775 @@
+/**
+ * Aligned strings with readable tail padding, and kernels that read past the end of them.
+ */
+
+#ifndef STRINGHELPERS_PADDED_STRING_H
+#define STRINGHELPERS_PADDED_STRING_H
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <expected>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "stringhelpers/config.h"
+#include "stringhelpers/stringhelpers.h"
+
+namespace strh
+{
+
+/**
+ * A string view followed by at least 'padded_view::padding' readable bytes.
+ *
+ * The strh functions taking a 'padded_view' load whole 16 byte blocks up to the end of the string,
+ * reading into the padding instead of finishing with a scalar loop. The padding bytes are read but
+ * never affect the result. Derives from 'std::string_view', so it can be passed to every strh
+ * function taking one; overloads taking a 'padded_view' are preferred when both exist.
+ *
+ * Obtained from a 'padded_string', or with 'assume_padded' for buffers managed elsewhere.
+ */
+class padded_view : public std::string_view
+{
+public:
+        /** The number of readable bytes guaranteed after the end of the view. */
+        static constexpr size_t padding = 64;
+
+        constexpr padded_view() = default;
+
+        /**
+         * Views 'string', which the caller guarantees is followed by 'padding' readable bytes.
+         *
+         * @param string the string to view.
+         *
+         * @return a padded_view of 'string'.
+         */
+        static constexpr padded_view assume_padded(std::string_view string)
+        {
+                return padded_view(string);
+        }
+
+        /**
+         * The end of a substring is never past the end of the view, so it keeps the padding.
+         *
+         * @see std::string_view::substr
+         */
+        constexpr padded_view substr(size_t pos = 0, size_t count = npos) const
+        {
+                return padded_view(std::string_view::substr(pos, count));
+        }
+
+private:
+        constexpr explicit padded_view(std::string_view string)
+                : std::string_view(string)
+        {
+        }
+};
+
+/**
+ * An owned string whose buffer is aligned to 'padded_string::alignment' bytes and followed by
+ * 'padded_view::padding' zeroed bytes.
+ *
+ * Meant for input buffers that are allocated once and refilled: 'assign' and 'resize' reuse the
+ * buffer while the new length fits the capacity. Converts implicitly to 'padded_view'.
+ */
+class padded_string
+{
+public:
+        /** The alignment of the buffer, one cache line. */
+        static constexpr size_t alignment = 64;
+
+        padded_string() = default;
+
+        /**
+         * Creates a padded_string of 'length' zero characters.
+         *
+         * @param length the length of the string.
+         */
+        explicit padded_string(size_t length)
+        {
+                resize(length);
+        }
+
+        /**
+         * Creates a padded_string holding 'string'.
+         *
+         * @param string the characters to copy.
+         */
+        padded_string(std::string_view string)
+        {
+                assign(string);
+        }
+
+        padded_string(const padded_string &other)
+        {
+                assign(other.view());
+        }
+
+        padded_string(padded_string &&other) noexcept
+                : data_(std::exchange(other.data_, nullptr)), length_(std::exchange(other.length_, 0)),
+                  capacity_(std::exchange(other.capacity_, 0))
+        {
+        }
+
+        padded_string &operator=(const padded_string &other)
+        {
+                if (this != &other)
+                        assign(other.view());
+                return *this;
+        }
+
+        padded_string &operator=(padded_string &&other) noexcept
+        {
+                if (this != &other)
+                {
+                        deallocate();
+                        data_ = std::exchange(other.data_, nullptr);
+                        length_ = std::exchange(other.length_, 0);
+                        capacity_ = std::exchange(other.capacity_, 0);
+                }
+                return *this;
+        }
+
+        ~padded_string()
+        {
+                deallocate();
+        }
+
+        /**
+         * Replaces the contents with 'string', reallocating only if it does not fit the capacity.
+         *
+         * @param string the characters to copy.
+         */
+        void assign(std::string_view string)
+        {
+                reserve_discard(string.length());
+                if (!string.empty())
+                        std::memcpy(data_, string.data(), string.length());
+                set_length(string.length());
+        }
+
+        /**
+         * Changes the length to 'length', keeping the existing characters. New characters are zero.
+         *
+         * @param length the new length.
+         */
+        void resize(size_t length)
+        {
+                reserve(length);
+                if (length > length_)
+                        std::memset(data_ + length_, 0, length - length_);
+                set_length(length);
+        }
+
+        /**
+         * Makes room for 'capacity' characters without changing the contents.
+         *
+         * @param capacity the number of characters to make room for.
+         */
+        void reserve(size_t capacity)
+        {
+                if (capacity <= capacity_)
+                        return;
+
+                char *old_data = data_;
+                size_t old_capacity = capacity_;
+                data_ = allocate(capacity);
+                capacity_ = capacity;
+                if (length_ != 0)
+                        std::memcpy(data_, old_data, length_);
+                release(old_data, old_capacity);
+        }
+
+        char *data()
+        {
+                return data_;
+        }
+
+        const char *data() const
+        {
+                return data_;
+        }
+
+        size_t length() const
+        {
+                return length_;
+        }
+
+        size_t size() const
+        {
+                return length_;
+        }
+
+        size_t capacity() const
+        {
+                return capacity_;
+        }
+
+        bool empty() const
+        {
+                return length_ == 0;
+        }
+
+        padded_view view() const
+        {
+                return padded_view::assume_padded({data_, length_});
+        }
+
+        operator padded_view() const
+        {
+                return view();
+        }
+
+private:
+        static char *allocate(size_t capacity)
+        {
+                auto *data = static_cast<char *>(::operator new(capacity + padded_view::padding,
+                                                                std::align_val_t{alignment}));
+                std::memset(data + capacity, 0, padded_view::padding);
+                return data;
+        }
+
+        static void release(char *data, size_t capacity)
+        {
+                if (data != nullptr)
+                        ::operator delete(data, capacity + padded_view::padding, std::align_val_t{alignment});
+        }
+
+        /**
+         * Makes room for 'capacity' characters, dropping the contents if it has to reallocate.
+         */
+        void reserve_discard(size_t capacity)
+        {
+                if (capacity <= capacity_)
+                        return;
+
+                deallocate();
+                data_ = allocate(capacity);
+                capacity_ = capacity;
+        }
+
+        /**
+         * Sets the length, zeroing the characters dropped by a shrink so the padding after the new
+         * length never holds stale data.
+         */
+        void set_length(size_t length)
+        {
+                if (length < length_)
+                        std::memset(data_ + length, 0, length_ - length);
+                length_ = length;
+        }
+
+        void deallocate()
+        {
+                release(data_, capacity_);
+                data_ = nullptr;
+                length_ = 0;
+                capacity_ = 0;
+        }
+
+        char *data_ = nullptr;
+        size_t length_ = 0;
+        size_t capacity_ = 0;
+};
+
+#if defined(__SSE2__)
+/**
+ * Helper functions for the padded_view kernels.
+ *
+ * @relatealso strh
+ */
+namespace priv_helpers
+{
+
+inline __m128i load_block(padded_view string, size_t pos)
+{
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(string.data() + pos));
+}
+
+/**
+ * Returns the bits of 'mask', a block starting at 'pos', that lie before 'end'.
+ */
+inline unsigned clip_mask(unsigned mask, size_t pos, size_t end)
+{
+        return end - pos >= 16 ? mask : mask & ((1u << (end - pos)) - 1);
+}
+
+inline unsigned byte_mask(__m128i matches)
+{
+        return static_cast<unsigned>(_mm_movemask_epi8(matches));
+}
+
+/**
+ * Returns the bytes of 'block' in the ASCII range ['lo', 'hi'].
+ */
+inline __m128i in_range(__m128i block, char lo, char hi)
+{
+        return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                             _mm_cmplt_epi8(block, _mm_set1_epi8(static_cast<char>(hi + 1))));
+}
+
+/**
+ * Returns the bytes of 'block' that are ' ', '\t' or '\n', the whitespaces of 'strip'.
+ */
+inline __m128i strip_whitespace(__m128i block)
+{
+        return _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),
+                            _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\t')),
+                                         _mm_cmpeq_epi8(block, _mm_set1_epi8('\n'))));
+}
+
+/**
+ * Checks that 'matching' selects every byte of 'string'.
+ *
+ * @tparam F a callable taking a '__m128i' block and returning a '__m128i' of matching bytes.
+ */
+template<typename F>
+inline bool all_blocks(padded_view string, F &&matching)
+{
+        for (size_t pos = 0; pos < string.length(); pos += 16)
+        {
+                unsigned full = clip_mask(0xffff, pos, string.length());
+                if ((byte_mask(matching(load_block(string, pos))) & full) != full)
+                        return false;
+        }
+        return true;
+}
+
+/**
+ * Returns the index of the first occurrence of 'key' in 'string' at or after 'pos', or
+ * 'std::string_view::npos'.
+ *
+ * Filters candidates on the first and last character of 'key' 16 positions at a time, then
+ * compares the whole key. Loads at most 'key.length() + 14' bytes past the last candidate, which
+ * stays inside the string and its padding.
+ */
+inline size_t padded_find_next(padded_view string, std::string_view key, size_t pos)
+{
+        if (key.length() > string.length())
+                return std::string_view::npos;
+
+        size_t end = string.length() - key.length() + 1;
+        __m128i first = _mm_set1_epi8(key.front());
+        __m128i last = _mm_set1_epi8(key.back());
+        for (; pos < end; pos += 16)
+        {
+                __m128i matches = _mm_and_si128(_mm_cmpeq_epi8(load_block(string, pos), first),
+                                                _mm_cmpeq_epi8(load_block(string, pos + key.length() - 1), last));
+                unsigned mask = clip_mask(byte_mask(matches), pos, end);
+                while (mask != 0)
+                {
+                        size_t idx = pos + static_cast<size_t>(std::countr_zero(mask));
+                        if (std::memcmp(string.data() + idx, key.data(), key.length()) == 0)
+                                return idx;
+                        mask &= mask - 1;
+                }
+        }
+        return std::string_view::npos;
+}
+}
+#endif
+
+/**
+ * Counts the number of times 'key' is in 'string', 16 bytes at a time with no scalar tail.
+ *
+ * @see count(std::string_view, char)
+ */
+inline size_t count(padded_view string, char key)
+{
+#if defined(__SSE2__)
+        STRH_INSTRUMENT(count, string.length());
+        __m128i needle = _mm_set1_epi8(key);
+        size_t ret = 0;
+        for (size_t pos = 0; pos < string.length(); pos += 16)
+        {
+                unsigned mask = priv_helpers::byte_mask(_mm_cmpeq_epi8(priv_helpers::load_block(string, pos), needle));
+                ret += static_cast<size_t>(std::popcount(priv_helpers::clip_mask(mask, pos, string.length())));
+        }
+        return ret;
+#else
+        return count(std::string_view(string), key);
+#endif
+}
+
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::count(padded_view, std::string_view)'.
+ *
+ * @return the number of times 'key' is in 'string', or 'errc::empty_key' if 'key' is empty.
+ */
+inline std::expected<size_t, errc> count(padded_view string, std::string_view key) noexcept
+{
+#if defined(__SSE2__)
+        STRH_INSTRUMENT(count, string.length());
+        if (key.empty())
+                return std::unexpected(errc::empty_key);
+
+        size_t ret = 0;
+        size_t pos = 0;
+        while ((pos = priv_helpers::padded_find_next(string, key, pos)) != std::string_view::npos)
+        {
+                ret++;
+                pos += key.length();
+        }
+        return ret;
+#else
+        return count(std::string_view(string), key);
+#endif
+}
+}
+
+/**
+ * Counts the number of times 'key' is in 'string', filtering candidates 16 bytes at a time.
+ *
+ * @throws std::invalid_argument Thrown if 'key' is empty.
+ *
+ * @see count(std::string_view, std::string_view)
+ */
+inline size_t count(padded_view string, std::string_view key)
+{
+        return priv_helpers::value_or_throw(nx::count(string, key));
+}
+
+/**
+ * Finds the indexes 'key' occurs in 'string', 16 bytes at a time with no scalar tail.
+ *
+ * @note Allocates the vector once.
+ *
+ * @see find(std::string_view, char)
+ */
+inline std::vector<size_t> find(padded_view string, char key)
+{
+#if defined(__SSE2__)
+        STRH_INSTRUMENT(find, string.length());
+        std::vector<size_t> ret;
+        ret.reserve(count(string, key));
+        __m128i needle = _mm_set1_epi8(key);
+        for (size_t pos = 0; pos < string.length(); pos += 16)
+        {
+                unsigned mask = priv_helpers::byte_mask(_mm_cmpeq_epi8(priv_helpers::load_block(string, pos), needle));
+                for (mask = priv_helpers::clip_mask(mask, pos, string.length()); mask != 0; mask &= mask - 1)
+                        ret.push_back(pos + static_cast<size_t>(std::countr_zero(mask)));
+        }
+        return ret;
+#else
+        return find(std::string_view(string), key);
+#endif
+}
+
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::find(padded_view, std::string_view)'.
+ *
+ * @return the indexes 'key' occurs in 'string', or 'errc::empty_key' if 'key' is empty.
+ *
+ * @note Allocation failures still throw, as in 'strh::find'.
+ */
+inline std::expected<std::vector<size_t>, errc> find(padded_view string, std::string_view key)
+{
+#if defined(__SSE2__)
+        STRH_INSTRUMENT(find, string.length());
+        if (key.empty())
+                return std::unexpected(errc::empty_key);
+
+        std::vector<size_t> ret;
+        for (size_t pos = priv_helpers::padded_find_next(string, key, 0); pos != std::string_view::npos;
+             pos = priv_helpers::padded_find_next(string, key, pos + 1))
+                ret.push_back(pos);
+        return ret;
+#else
+        return find(std::string_view(string), key);
+#endif
+}
+}
+
+/**
+ * Finds the indexes 'key' occurs in 'string', filtering candidates 16 bytes at a time.
+ *
+ * @throws std::invalid_argument Thrown if 'key' is empty.
+ *
+ * @note Reads 'string' once; the vector grows as occurrences are found.
+ *
+ * @see find(std::string_view, std::string_view)
+ */
+inline std::vector<size_t> find(padded_view string, std::string_view key)
+{
+        return priv_helpers::value_or_throw(nx::find(string, key));
+}
+
+/**
+ * Splits 'string' into substrings separated by 'delimiter', finding delimiters 16 bytes at a time.
+ *
+ * @note Allocates the vector once, plus once per substring too long for the small string buffer.
+ *
+ * @see split(std::string_view, char)
+ */
+inline std::vector<std::string> split(padded_view string, char delimiter)
+{
+#if defined(__SSE2__)
+        STRH_INSTRUMENT(split, string.length());
+        std::vector<std::string> ret;
+        ret.reserve(count(string, delimiter) + 1);
+        __m128i needle = _mm_set1_epi8(delimiter);
+        size_t start = 0;
+        for (size_t pos = 0; pos < string.length(); pos += 16)
+        {
+                unsigned mask = priv_helpers::byte_mask(_mm_cmpeq_epi8(priv_helpers::load_block(string, pos), needle));
+                for (mask = priv_helpers::clip_mask(mask, pos, string.length()); mask != 0; mask &= mask - 1)
+                {
+                        size_t end = pos + static_cast<size_t>(std::countr_zero(mask));
+                        ret.emplace_back(string.data() + start, end - start);
+                        start = end + 1;
+                }
+        }
+
+        if (start < string.length())
+                ret.emplace_back(string.data() + start, string.length() - start);
+
+        return ret;
+#else
+        return split(std::string_view(string), delimiter);
+#endif
+}
+
+/**
+ * Removes whitespaces at the beginning and end of 'string' without copying, 16 bytes at a time.
+ *
+ * @return the part of 'string' with no whitespaces at the beginning nor end. It is a substring of
+ * 'string', so it is padded too.
+ *
+ * @note whitespaces are ' ', '\t'. '\n'.
+ *
+ * @see strip(std::string)
+ */
+inline padded_view strip(padded_view string)
+{
+#if defined(__SSE2__)
+        STRH_INSTRUMENT(strip, string.length());
+        size_t front = string.length();
+        for (size_t pos = 0; pos < string.length(); pos += 16)
+        {
+                unsigned mask = ~priv_helpers::byte_mask(priv_helpers::strip_whitespace(priv_helpers::load_block(string, pos)));
+                mask = priv_helpers::clip_mask(mask & 0xffff, pos, string.length());
+                if (mask != 0)
+                {
+                        front = pos + static_cast<size_t>(std::countr_zero(mask));
+                        break;
+                }
+        }
+        if (front == string.length())
+                return string.substr(string.length());
+
+        // Walks back over the same 16 byte blocks the forward scan used, so no load starts before
+        // the string.
+        size_t back = front;
+        for (size_t pos = (string.length() - 1) / 16 * 16;; pos -= 16)
+        {
+                unsigned mask = ~priv_helpers::byte_mask(priv_helpers::strip_whitespace(priv_helpers::load_block(string, pos)));
+                mask = priv_helpers::clip_mask(mask & 0xffff, pos, string.length());
+                if (mask != 0)
+                {
+                        back = pos + static_cast<size_t>(std::bit_width(mask)) - 1;
+                        break;
+                }
+        }
+        return string.substr(front, back - front + 1);
+#else
+        size_t front = string.find_first_not_of(" \t\n");
+        if (front == std::string_view::npos)
+                return string.substr(string.length());
+        return string.substr(front, string.find_last_not_of(" \t\n") - front + 1);
+#endif
+}
+
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::all_nums(padded_view)'.
+ *
+ * @return whether all characters in 'string' are '0' to '9', or 'errc::empty_string' if 'string'
+ * is empty.
+ */
+inline std::expected<bool, errc> all_nums(padded_view string) noexcept
+{
+#if defined(__SSE2__)
+        STRH_INSTRUMENT(all_nums, string.length());
+        if (string.empty())
+                return std::unexpected(errc::empty_string);
+
+        return priv_helpers::all_blocks(string, [](__m128i block) {
+                return priv_helpers::in_range(block, '0', '9');
+        });
+#else
+        return all_nums(std::string_view(string));
+#endif
+}
+
+/**
+ * Non-throwing 'strh::all_alphabetical(padded_view)'.
+ *
+ * @return whether all characters in 'string' are ASCII letters, or 'errc::empty_string' if
+ * 'string' is empty.
+ */
+inline std::expected<bool, errc> all_alphabetical(padded_view string) noexcept
+{
+#if defined(__SSE2__)
+        STRH_INSTRUMENT(all_alphabetical, string.length());
+        if (string.empty())
+                return std::unexpected(errc::empty_string);
+
+        return priv_helpers::all_blocks(string, [](__m128i block) {
+                return _mm_or_si128(priv_helpers::in_range(block, 'a', 'z'), priv_helpers::in_range(block, 'A', 'Z'));
+        });
+#else
+        return all_alphabetical(std::string_view(string));
+#endif
+}
+
+/**
+ * Non-throwing 'strh::all_lowercase(padded_view)'.
+ *
+ * @return whether all characters in 'string' are 'a' to 'z', or 'errc::empty_string' if 'string'
+ * is empty.
+ */
+inline std::expected<bool, errc> all_lowercase(padded_view string) noexcept
+{
+#if defined(__SSE2__)
+        STRH_INSTRUMENT(all_lowercase, string.length());
+        if (string.empty())
+                return std::unexpected(errc::empty_string);
+
+        return priv_helpers::all_blocks(string, [](__m128i block) {
+                return priv_helpers::in_range(block, 'a', 'z');
+        });
+#else
+        return all_lowercase(std::string_view(string));
+#endif
+}
+
+/**
+ * Non-throwing 'strh::all_uppercase(padded_view)'.
+ *
+ * @return whether all characters in 'string' are 'A' to 'Z', or 'errc::empty_string' if 'string'
+ * is empty.
+ */
+inline std::expected<bool, errc> all_uppercase(padded_view string) noexcept
+{
+#if defined(__SSE2__)
+        STRH_INSTRUMENT(all_uppercase, string.length());
+        if (string.empty())
+                return std::unexpected(errc::empty_string);
+
+        return priv_helpers::all_blocks(string, [](__m128i block) {
+                return priv_helpers::in_range(block, 'A', 'Z');
+        });
+#else
+        return all_uppercase(std::string_view(string));
+#endif
+}
+
+/**
+ * Non-throwing 'strh::all_spaces(padded_view)'.
+ *
+ * @return whether all characters in 'string' are ' ', '\t', '\n', '\v', '\f' or '\r', or
+ * 'errc::empty_string' if 'string' is empty.
+ */
+inline std::expected<bool, errc> all_spaces(padded_view string) noexcept
+{
+#if defined(__SSE2__)
+        STRH_INSTRUMENT(all_spaces, string.length());
+        if (string.empty())
+                return std::unexpected(errc::empty_string);
+
+        return priv_helpers::all_blocks(string, [](__m128i block) {
+                return _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')), priv_helpers::in_range(block, '\t', '\r'));
+        });
+#else
+        return all_spaces(std::string_view(string));
+#endif
+}
+}
+
+/**
+ * Checks if all characters in 'string' are numbers, 16 bytes at a time.
+ *
+ * Classifies ASCII only, like the "C" locale.
+ *
+ * @throws std::invalid_argument Thrown if 'string' is empty.
+ *
+ * @see all_nums(std::string_view)
+ */
+inline bool all_nums(padded_view string)
+{
+        return priv_helpers::value_or_throw(nx::all_nums(string));
+}
+
+/**
+ * Checks if all characters in 'string' are alphabetical (letters), 16 bytes at a time.
+ *
+ * Classifies ASCII only, like the "C" locale.
+ *
+ * @throws std::invalid_argument Thrown if 'string' is empty.
+ *
+ * @see all_alphabetical(std::string_view)
+ */
+inline bool all_alphabetical(padded_view string)
+{
+        return priv_helpers::value_or_throw(nx::all_alphabetical(string));
+}
+
+/**
+ * Checks if all characters in 'string' are lowercase, 16 bytes at a time.
+ *
+ * Classifies ASCII only, like the "C" locale.
+ *
+ * @throws std::invalid_argument Thrown if 'string' is empty.
+ *
+ * @see all_lowercase(std::string_view)
+ */
+inline bool all_lowercase(padded_view string)
+{
+        return priv_helpers::value_or_throw(nx::all_lowercase(string));
+}
+
+/**
+ * Checks if all characters in 'string' are uppercase, 16 bytes at a time.
+ *
+ * Classifies ASCII only, like the "C" locale.
+ *
+ * @throws std::invalid_argument Thrown if 'string' is empty.
+ *
+ * @see all_uppercase(std::string_view)
+ */
+inline bool all_uppercase(padded_view string)
+{
+        return priv_helpers::value_or_throw(nx::all_uppercase(string));
+}
+
+/**
+ * Checks if all characters in 'string' are spaces, 16 bytes at a time.
+ *
+ * Classifies ASCII only, like the "C" locale.
+ *
+ * @throws std::invalid_argument Thrown if 'string' is empty.
+ *
+ * @see all_spaces(std::string_view)
+ */
+inline bool all_spaces(padded_view string)
+{
+        return priv_helpers::value_or_throw(nx::all_spaces(string));
+}
+}
+
+#endif //STRINGHELPERS_PADDED_STRING_H
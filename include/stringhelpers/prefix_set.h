@@ -0,0 +1,227 @@
+/**
+ * Sets of prefixes or suffixes matched against a string in one walk.
+ */
+
+#ifndef STRINGHELPERS_PREFIX_SET_H
+#define STRINGHELPERS_PREFIX_SET_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "stringhelpers/hash.h"
+#include "stringhelpers/stringhelpers.h"
+
+namespace strh
+{
+
+/**
+ * A set of prefixes, or of suffixes when 'FromEnd' is 'true', that finds the longest one a string
+ * starts, or ends, with.
+ *
+ * The strings are kept in a trie laid out in three flat arrays: the nodes, and the labels and
+ * targets of their edges, with the edges of each node next to each other. Matching walks the trie
+ * one character of the string at a time, so its cost depends on the length of the match, not on
+ * the number of strings in the set.
+ *
+ * @tparam FromEnd whether the strings are suffixes, matched from the end of the string backward.
+ */
+template<bool FromEnd>
+class basic_prefix_set
+{
+public:
+        /** Returned by 'match' when no string of the set matches. */
+        static constexpr size_t npos = SIZE_MAX;
+
+        basic_prefix_set()
+        {
+                rebuild();
+        }
+
+        /**
+         * Creates a set of 'strings', building the trie once.
+         *
+         * The ids are those calling 'add' with every string in order would return: repeated strings
+         * share the id of their first occurrence.
+         *
+         * @tparam Range a range of strings convertible to 'std::string_view'.
+         *
+         * @param strings the prefixes, or suffixes, of the set.
+         */
+        template<typename Range>
+        explicit basic_prefix_set(const Range &strings)
+        {
+                std::unordered_map<std::string_view, size_t, hasher, std::equal_to<>> ids;
+                for (const auto &string: strings)
+                {
+                        std::string_view view = string;
+                        if (ids.emplace(view, strings_.size()).second)
+                                strings_.emplace_back(view);
+                }
+                rebuild();
+        }
+
+        /**
+         * Adds 'string' to the set.
+         *
+         * Every add of a new string rebuilds the trie, so a set of many strings is best built
+         * at once by the constructor taking a range.
+         *
+         * @param string the prefix, or suffix, to add.
+         *
+         * @return the id of 'string': '0' for the first string added, '1' for the next, and so on.
+         * Adding a string already in the set returns its id.
+         */
+        size_t add(std::string_view string)
+        {
+                size_t id = find(string);
+                if (id != npos)
+                        return id;
+                strings_.emplace_back(string);
+                rebuild();
+                return strings_.size() - 1;
+        }
+
+        /**
+         * Finds the longest string of the set that 'string' starts with, or ends with for a
+         * suffix set.
+         *
+         * @param string the string to match.
+         *
+         * @return the id of the longest matching string, or 'npos' if none matches.
+         */
+        size_t match(std::string_view string) const
+        {
+                STRH_INSTRUMENT(prefix_set, string.length());
+                const node *current = &nodes_[0];
+                size_t ret = current->id;
+                for (size_t i = 0; i < string.length() && current->edge_count != 0; i++)
+                {
+                        char ch = FromEnd ? string[string.length() - 1 - i] : string[i];
+                        // Most nodes have a handful of edges, too few for 'memchr' to pay off.
+                        const char *labels = labels_.data() + current->first_edge;
+                        size_t edge = 0;
+                        while (edge < current->edge_count && labels[edge] != ch)
+                                edge++;
+                        if (edge == current->edge_count)
+                                break;
+                        current = &nodes_[targets_[current->first_edge + edge]];
+                        if (current->id != npos)
+                                ret = current->id;
+                }
+                return ret;
+        }
+
+        /**
+         * @return the string with id 'id'.
+         */
+        std::string_view operator[](size_t id) const
+        {
+                return strings_[id];
+        }
+
+        size_t size() const
+        {
+                return strings_.size();
+        }
+
+private:
+        struct node
+        {
+                uint32_t first_edge;
+                uint32_t edge_count;
+                size_t id;
+        };
+
+        /**
+         * Returns the id of 'string' if it is in the set, walking the trie, or 'npos'.
+         */
+        size_t find(std::string_view string) const
+        {
+                const node *current = &nodes_[0];
+                for (size_t i = 0; i < string.length(); i++)
+                {
+                        char ch = FromEnd ? string[string.length() - 1 - i] : string[i];
+                        const char *labels = labels_.data() + current->first_edge;
+                        size_t edge = 0;
+                        while (edge < current->edge_count && labels[edge] != ch)
+                                edge++;
+                        if (edge == current->edge_count)
+                                return npos;
+                        current = &nodes_[targets_[current->first_edge + edge]];
+                }
+                return current->id;
+        }
+
+        /**
+         * Rebuilds the trie from 'strings_', walking them in sorted order so the children of each
+         * node are a contiguous range.
+         */
+        void rebuild()
+        {
+                std::vector<std::pair<std::string, size_t>> keys;
+                keys.reserve(strings_.size());
+                for (size_t id = 0; id < strings_.size(); id++)
+                {
+                        keys.emplace_back(strings_[id], id);
+                        if constexpr (FromEnd)
+                                std::reverse(keys.back().first.begin(), keys.back().first.end());
+                }
+                std::sort(keys.begin(), keys.end());
+
+                nodes_.clear();
+                labels_.clear();
+                targets_.clear();
+                build(keys, 0, keys.size(), 0);
+        }
+
+        uint32_t build(const std::vector<std::pair<std::string, size_t>> &keys, size_t begin, size_t end,
+                       size_t depth)
+        {
+                uint32_t index = static_cast<uint32_t>(nodes_.size());
+                nodes_.push_back({0, 0, npos});
+                if (begin < end && keys[begin].first.length() == depth)
+                        nodes_[index].id = keys[begin++].second;
+
+                // The keys sharing a character at 'depth' are next to each other once sorted.
+                std::vector<size_t> groups;
+                for (size_t i = begin; i < end; i++)
+                {
+                        if (i == begin || keys[i].first[depth] != keys[i - 1].first[depth])
+                                groups.push_back(i);
+                }
+                groups.push_back(end);
+
+                uint32_t first_edge = static_cast<uint32_t>(labels_.size());
+                nodes_[index].first_edge = first_edge;
+                nodes_[index].edge_count = static_cast<uint32_t>(groups.size() - 1);
+                for (size_t g = 0; g + 1 < groups.size(); g++)
+                {
+                        labels_.push_back(keys[groups[g]].first[depth]);
+                        targets_.push_back(0);
+                }
+                for (size_t g = 0; g + 1 < groups.size(); g++)
+                        targets_[first_edge + g] = build(keys, groups[g], groups[g + 1], depth + 1);
+                return index;
+        }
+
+        std::vector<std::string> strings_;
+        std::vector<node> nodes_;
+        /** The character of every edge, grouped by node. */
+        std::vector<char> labels_;
+        /** The node every edge leads to, in the order of 'labels_'. */
+        std::vector<uint32_t> targets_;
+};
+
+/** A set of prefixes, matched with 'match' like successive 'starts_with' calls keeping the longest. */
+using prefix_set = basic_prefix_set<false>;
+
+/** A set of suffixes, matched with 'match' like successive 'ends_with' calls keeping the longest. */
+using suffix_set = basic_prefix_set<true>;
+}
+
+#endif //STRINGHELPERS_PREFIX_SET_H
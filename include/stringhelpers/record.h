@@ -0,0 +1,237 @@
+/**
+ * Binding of delimited lines to structs, described at compile time.
+ */
+
+#ifndef STRINGHELPERS_RECORD_H
+#define STRINGHELPERS_RECORD_H
+
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "stringhelpers/stringhelpers.h"
+
+namespace strh
+{
+
+/**
+ * Parses a field with the type of its member.
+ *
+ * 'std::string_view' members get a view of the field, valid as long as the line. 'std::string'
+ * members get a copy. 'char' members need a field of exactly one character. Other arithmetic
+ * members are parsed with 'std::from_chars' and the whole field must be consumed.
+ */
+struct default_parser
+{
+        template<typename T>
+        bool operator()(std::string_view token, T &value) const
+        {
+                if constexpr (std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string>)
+                {
+                        value = T(token);
+                        return true;
+                }
+                else if constexpr (std::is_same_v<T, char>)
+                {
+                        if (token.length() != 1)
+                                return false;
+                        value = token[0];
+                        return true;
+                }
+                else
+                {
+                        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+                                      "default_parser cannot parse this member type; give the field a parser");
+                        auto [end, error] = std::from_chars(token.data(), token.data() + token.length(), value);
+                        return error == std::errc() && end == token.data() + token.length() && !token.empty();
+                }
+        }
+};
+
+/**
+ * Describes one field of a record: column 'Index' of the line is parsed into 'Member'.
+ *
+ * @tparam Member a pointer to the data member to set.
+ * @tparam Index the zero-based column of the field in the line.
+ * @tparam Parser a default-constructible callable taking the field as a 'std::string_view' and a
+ * reference to the member, returning 'false' if the field is invalid.
+ */
+template<auto Member, size_t Index, typename Parser = default_parser>
+struct field
+{
+        static constexpr auto member = Member;
+        static constexpr size_t index = Index;
+        using parser = Parser;
+};
+
+/**
+ * The fields of a record. A record type declares them as 'using record_fields = fields<...>'.
+ *
+ * @tparam Fields 'field' descriptors, in any order.
+ */
+template<typename... Fields>
+struct fields
+{
+};
+
+/**
+ * The error of a line that could not be parsed.
+ */
+struct record_error
+{
+        /** 'errc::missing_field' or 'errc::invalid_field'. */
+        errc code;
+        /** The column of the field that is missing or invalid. */
+        size_t column;
+
+        bool operator==(const record_error &) const = default;
+};
+
+/**
+ * Helper functions for parse_record.
+ *
+ * @relatealso strh
+ */
+namespace priv_helpers
+{
+
+/**
+ * The current column of a line being parsed. Columns before the last field are found with one
+ * 'memchr' each and never looked at otherwise.
+ */
+class record_cursor
+{
+public:
+        record_cursor(std::string_view line, char delimiter)
+                : line_(line), delimiter_(delimiter)
+        {
+                end_ = find_end(0);
+        }
+
+        /**
+         * Moves to 'column', which must not be before the current column.
+         *
+         * @return 'false' if the line has no such column.
+         */
+        bool advance(size_t column)
+        {
+                for (; column_ < column; column_++)
+                {
+                        if (end_ == line_.length())
+                                return false;
+                        start_ = end_ + 1;
+                        end_ = find_end(start_);
+                }
+                return true;
+        }
+
+        std::string_view token() const
+        {
+                return line_.substr(start_, end_ - start_);
+        }
+
+private:
+        size_t find_end(size_t start) const
+        {
+                if (start == line_.length())
+                        return start;
+                const void *found = std::memchr(line_.data() + start, delimiter_, line_.length() - start);
+                return found == nullptr ? line_.length() : static_cast<const char *>(found) - line_.data();
+        }
+
+        std::string_view line_;
+        char delimiter_;
+        size_t start_ = 0;
+        size_t end_ = 0;
+        size_t column_ = 0;
+};
+
+/**
+ * The positions of 'Fields' sorted by column, so a line is parsed left to right in one pass.
+ */
+template<typename... Fields>
+constexpr std::array<size_t, sizeof...(Fields)> field_order()
+{
+        std::array<size_t, sizeof...(Fields)> columns = {Fields::index...};
+        std::array<size_t, sizeof...(Fields)> order{};
+        // An insertion sort: stable and constexpr, and records have few fields.
+        for (size_t i = 0; i < order.size(); i++)
+        {
+                size_t j = i;
+                for (; j > 0 && columns[order[j - 1]] > columns[i]; j--)
+                        order[j] = order[j - 1];
+                order[j] = i;
+        }
+        return order;
+}
+
+template<typename Field, typename T>
+inline bool parse_field(record_cursor &cursor, T &record, record_error &error)
+{
+        if (!cursor.advance(Field::index))
+        {
+                error = {errc::missing_field, Field::index};
+                return false;
+        }
+        if (!typename Field::parser{}(cursor.token(), record.*Field::member))
+        {
+                error = {errc::invalid_field, Field::index};
+                return false;
+        }
+        return true;
+}
+
+template<typename T, typename... Fields, size_t... I>
+inline std::expected<T, record_error> parse_fields(std::string_view line, char delimiter, fields<Fields...>,
+                                                   std::index_sequence<I...>)
+{
+        using field_tuple = std::tuple<Fields...>;
+        constexpr std::array<size_t, sizeof...(Fields)> order = field_order<Fields...>();
+
+        T record{};
+        record_cursor cursor(line, delimiter);
+        record_error error{};
+        if (!(parse_field<std::tuple_element_t<order[I], field_tuple>>(cursor, record, error) && ...))
+                return std::unexpected(error);
+        return record;
+}
+
+template<typename... Fields>
+constexpr size_t field_count(fields<Fields...>)
+{
+        return sizeof...(Fields);
+}
+}
+
+/**
+ * Parses 'line' into a 'T' in one pass, without building a vector of tokens.
+ *
+ * Fields are parsed in column order whatever order they are declared in, and parsing stops after
+ * the last declared column. Columns without a field are skipped without being parsed. Members
+ * without a field keep their default value.
+ *
+ * @tparam T the record type, default-constructible.
+ * @tparam Fields the 'fields' of 'T', by default 'T::record_fields'.
+ *
+ * @param line the line to parse.
+ * @param delimiter the character separating the columns of 'line'.
+ *
+ * @return the parsed record, or the 'record_error' of the first field, in column order, that is
+ * missing or invalid.
+ */
+template<typename T, typename Fields = typename T::record_fields>
+inline std::expected<T, record_error> parse_record(std::string_view line, char delimiter)
+{
+        STRH_INSTRUMENT(parse_record, line.length());
+        return priv_helpers::parse_fields<T>(line, delimiter, Fields{},
+                                             std::make_index_sequence<priv_helpers::field_count(Fields{})>());
+}
+}
+
+#endif //STRINGHELPERS_RECORD_H
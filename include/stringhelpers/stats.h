@@ -0,0 +1,385 @@
+/**
+ * Opt-in instrumentation of the strh functions.
+ *
+ * Define 'STRINGHELPERS_INSTRUMENT' before including any stringhelpers header (or pass
+ * '-DSTRINGHELPERS_INSTRUMENT') to record, for every strh function, how often it is called, how
+ * many input bytes it processes, how many allocations it makes and a histogram of its latency.
+ * Without the macro the hooks expand to nothing and 'snapshot' returns all zeros. Calls that one
+ * strh function makes to another, such as 'is_in' calling 'count', are recorded for both.
+ *
+ * Allocations are only counted if the program routes its allocations through
+ * 'strh::stats::count_allocation', for example by defining 'STRINGHELPERS_INSTRUMENT_NEW' in
+ * exactly one translation unit, which replaces the global 'operator new' with a counting one.
+ */
+
+#ifndef STRINGHELPERS_STATS_H
+#define STRINGHELPERS_STATS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "stringhelpers/config.h"
+
+#ifdef STRINGHELPERS_INSTRUMENT
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace strh::stats
+{
+
+/**
+ * The instrumented functions.
+ */
+enum class function
+{
+        capitalize, multiply, align, count, histogram, count_any, ends_with, starts_with, is_in,
+        all_nums, all_alphabetical, all_lowercase, all_uppercase, all_spaces, split, split_lines,
+        strip, swap_cases, find_first, find_last, find_last_n, find, ifind, icount, iis_in,
+        istarts_with, iends_with, replace, remove_nums, remove_alphabetical, split_alphabetical,
+        from_parameter_pack, from_vector, join, format, to_upper, parse_record, compiled_format,
+        edit_distance, within_distance, nearest, glob, prefix_set, sort_tokens, unique_tokens,
+        count_distinct, line_index, count_
+};
+
+constexpr size_t function_count = static_cast<size_t>(function::count_);
+
+constexpr std::array<std::string_view, function_count> function_names = {
+        "capitalize", "multiply", "align", "count", "histogram", "count_any", "ends_with",
+        "starts_with", "is_in", "all_nums", "all_alphabetical", "all_lowercase", "all_uppercase",
+        "all_spaces", "split", "split_lines", "strip", "swap_cases", "find_first", "find_last",
+        "find_last_n", "find", "ifind", "icount", "iis_in", "istarts_with", "iends_with",
+        "replace", "remove_nums", "remove_alphabetical", "split_alphabetical",
+        "from_parameter_pack", "from_vector", "join", "format", "to_upper", "parse_record",
+        "compiled_format", "edit_distance", "within_distance", "nearest", "glob",
+        "prefix_set", "sort_tokens", "unique_tokens", "count_distinct",
+        "line_index",
+};
+
+/** Bucket 'i' of a latency histogram counts calls taking [2^i, 2^(i+1)) ticks. */
+constexpr size_t histogram_buckets = 32;
+
+/**
+ * Whether instrumentation is compiled in.
+ */
+#ifdef STRINGHELPERS_INSTRUMENT
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+/**
+ * The recorded totals of one function.
+ */
+struct function_stats
+{
+        std::string_view name;
+        uint64_t calls = 0;
+        uint64_t bytes = 0;
+        uint64_t allocations = 0;
+        /** Total latency in ticks: TSC cycles on x86, nanoseconds elsewhere. */
+        uint64_t ticks = 0;
+        std::array<uint64_t, histogram_buckets> histogram{};
+};
+
+/**
+ * Helper functions for the instrumentation.
+ *
+ * @relatealso strh::stats
+ */
+namespace priv_helpers
+{
+
+/**
+ * Counters of one thread. Only the owning thread writes them, so updates are plain relaxed
+ * load/store pairs rather than atomic read-modify-writes; atomics only keep 'snapshot' race-free.
+ */
+struct counters
+{
+        struct entry
+        {
+                std::atomic<uint64_t> calls{0};
+                std::atomic<uint64_t> bytes{0};
+                std::atomic<uint64_t> allocations{0};
+                std::atomic<uint64_t> ticks{0};
+                std::array<std::atomic<uint64_t>, histogram_buckets> histogram{};
+        };
+
+        std::array<entry, function_count> functions;
+};
+
+/**
+ * Allocations made by the current thread. A plain thread-local so that counting an allocation
+ * never allocates.
+ */
+inline thread_local uint64_t allocations = 0;
+
+inline void bump(std::atomic<uint64_t> &counter, uint64_t amount)
+{
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/**
+ * Adds 'from' to 'to' field by field.
+ */
+inline void merge(const counters &from, function_stats (&to)[function_count])
+{
+        for (size_t i = 0; i < function_count; i++)
+        {
+                const counters::entry &entry = from.functions[i];
+                to[i].calls += entry.calls.load(std::memory_order_relaxed);
+                to[i].bytes += entry.bytes.load(std::memory_order_relaxed);
+                to[i].allocations += entry.allocations.load(std::memory_order_relaxed);
+                to[i].ticks += entry.ticks.load(std::memory_order_relaxed);
+                for (size_t b = 0; b < histogram_buckets; b++)
+                        to[i].histogram[b] += entry.histogram[b].load(std::memory_order_relaxed);
+        }
+}
+
+/**
+ * The counters of every live thread, plus the totals of threads that have exited.
+ */
+struct registry
+{
+        std::mutex mutex;
+        std::vector<const counters *> live;
+        function_stats retired[function_count]{};
+};
+
+inline registry &global_registry()
+{
+        static registry instance;
+        return instance;
+}
+
+/**
+ * Registers the counters of a thread on creation and folds them into the retired totals when
+ * the thread exits.
+ */
+struct thread_counters
+{
+        thread_counters()
+        {
+                registry &reg = global_registry();
+                std::lock_guard lock(reg.mutex);
+                reg.live.push_back(&data);
+        }
+
+        ~thread_counters()
+        {
+                registry &reg = global_registry();
+                std::lock_guard lock(reg.mutex);
+                merge(data, reg.retired);
+                std::erase(reg.live, &data);
+        }
+
+        counters data;
+};
+
+inline counters &local()
+{
+        thread_local thread_counters instance;
+        return instance.data;
+}
+
+#ifdef STRINGHELPERS_INSTRUMENT
+inline uint64_t ticks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+#endif
+}
+
+/**
+ * Records one allocation made by the current thread.
+ *
+ * Call it from a replacement 'operator new' to attribute allocations to strh functions.
+ */
+inline void count_allocation()
+{
+#ifdef STRINGHELPERS_INSTRUMENT
+        priv_helpers::allocations++;
+#endif
+}
+
+#ifdef STRINGHELPERS_INSTRUMENT
+/**
+ * Records one call of a function from construction to destruction.
+ */
+class scope
+{
+public:
+        /**
+         * Records nothing during constant evaluation, so instrumented functions stay constexpr.
+         */
+        constexpr scope(function fn, size_t bytes)
+        {
+                if (std::is_constant_evaluated())
+                        return;
+
+                entry_ = &priv_helpers::local().functions[static_cast<size_t>(fn)];
+                allocations_ = priv_helpers::allocations;
+                start_ = priv_helpers::ticks();
+                priv_helpers::bump(entry_->calls, 1);
+                priv_helpers::bump(entry_->bytes, bytes);
+        }
+
+        scope(const scope &) = delete;
+        scope &operator=(const scope &) = delete;
+
+        constexpr ~scope()
+        {
+                if (entry_ == nullptr)
+                        return;
+
+                uint64_t elapsed = priv_helpers::ticks() - start_;
+                priv_helpers::bump(entry_->ticks, elapsed);
+                size_t bucket = std::min<size_t>(std::bit_width(elapsed), histogram_buckets) - (elapsed != 0);
+                priv_helpers::bump(entry_->histogram[bucket], 1);
+                priv_helpers::bump(entry_->allocations, priv_helpers::allocations - allocations_);
+        }
+
+private:
+        priv_helpers::counters::entry *entry_ = nullptr;
+        uint64_t allocations_ = 0;
+        uint64_t start_ = 0;
+};
+#endif
+
+/**
+ * Sums the counters of every thread, including threads that have exited.
+ *
+ * @return the totals of every instrumented function, indexed by 'function'.
+ */
+inline std::vector<function_stats> snapshot()
+{
+        function_stats totals[function_count]{};
+        {
+                priv_helpers::registry &reg = priv_helpers::global_registry();
+                std::lock_guard lock(reg.mutex);
+                for (size_t i = 0; i < function_count; i++)
+                        totals[i] = reg.retired[i];
+                for (const priv_helpers::counters *thread : reg.live)
+                        priv_helpers::merge(*thread, totals);
+        }
+
+        std::vector<function_stats> ret(totals, totals + function_count);
+        for (size_t i = 0; i < function_count; i++)
+                ret[i].name = function_names[i];
+        return ret;
+}
+}
+
+#ifdef STRINGHELPERS_INSTRUMENT
+#define STRH_INSTRUMENT(fn, bytes) \
+        ::strh::stats::scope strh_stats_scope_(::strh::stats::function::fn, (bytes))
+#else
+#define STRH_INSTRUMENT(fn, bytes) ((void) 0)
+#endif
+
+#if defined(STRINGHELPERS_INSTRUMENT) && defined(STRINGHELPERS_INSTRUMENT_NEW)
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Every form of 'operator new' is replaced, so all allocations are counted and each is freed by the
+// matching 'operator delete'. The deletes are not inlined, so GCC does not pair the inlined free()
+// with a 'new' it cannot see and warn about a mismatch.
+
+namespace strh::stats::priv_helpers
+{
+inline void *counted_alloc(std::size_t size, std::size_t alignment)
+{
+        ::strh::stats::count_allocation();
+        size = size == 0 ? 1 : size;
+        if (alignment <= alignof(std::max_align_t))
+                return std::malloc(size);
+#ifdef _MSC_VER
+        return _aligned_malloc(size, alignment);
+#else
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+inline void counted_free(void *ptr, std::size_t alignment)
+{
+#ifdef _MSC_VER
+        if (alignment > alignof(std::max_align_t))
+                return _aligned_free(ptr);
+#else
+        (void) alignment;
+#endif
+        std::free(ptr);
+}
+}
+
+void *operator new(std::size_t size)
+{
+        if (void *ptr = ::strh::stats::priv_helpers::counted_alloc(size, 0))
+                return ptr;
+        STRH_THROW(std::bad_alloc());
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+        if (void *ptr = ::strh::stats::priv_helpers::counted_alloc(size, static_cast<std::size_t>(alignment)))
+                return ptr;
+        STRH_THROW(std::bad_alloc());
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+        return ::strh::stats::priv_helpers::counted_alloc(size, 0);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+        return ::strh::stats::priv_helpers::counted_alloc(size, static_cast<std::size_t>(alignment));
+}
+
+[[gnu::noinline]] void operator delete(void *ptr) noexcept
+{
+        ::strh::stats::priv_helpers::counted_free(ptr, 0);
+}
+
+[[gnu::noinline]] void operator delete(void *ptr, std::size_t) noexcept
+{
+        ::strh::stats::priv_helpers::counted_free(ptr, 0);
+}
+
+[[gnu::noinline]] void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+        ::strh::stats::priv_helpers::counted_free(ptr, 0);
+}
+
+[[gnu::noinline]] void operator delete(void *ptr, std::align_val_t alignment) noexcept
+{
+        ::strh::stats::priv_helpers::counted_free(ptr, static_cast<std::size_t>(alignment));
+}
+
+[[gnu::noinline]] void operator delete(void *ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+        ::strh::stats::priv_helpers::counted_free(ptr, static_cast<std::size_t>(alignment));
+}
+
+[[gnu::noinline]] void operator delete(void *ptr, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+        ::strh::stats::priv_helpers::counted_free(ptr, static_cast<std::size_t>(alignment));
+}
+#endif
+
+#endif //STRINGHELPERS_STATS_H
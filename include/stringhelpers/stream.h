@@ -0,0 +1,269 @@
+/**
+ * Incremental splitting and searching of data arriving in chunks.
+ */
+
+#ifndef STRINGHELPERS_STREAM_H
+#define STRINGHELPERS_STREAM_H
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "stringhelpers/config.h"
+
+namespace strh
+{
+
+/**
+ * Finds every occurrence of a key in a stream fed one chunk at a time.
+ *
+ * Reports the same indexes 'find' would report on the concatenation of all chunks, including
+ * occurrences straddling chunk boundaries. Only the last 'key.length() - 1' bytes of the stream
+ * are kept between chunks.
+ *
+ * @see find
+ */
+class stream_searcher
+{
+public:
+        /**
+         * Creates a searcher for 'key'.
+         *
+         * @param key the string to search for.
+         *
+         * @throws std::invalid_argument Thrown if 'key' is empty.
+         */
+        explicit stream_searcher(std::string_view key)
+                : key_(key)
+        {
+                if (key_.empty())
+                        STRH_THROW(std::invalid_argument("key cannot be empty"));
+        }
+
+        /**
+         * Searches the next chunk of the stream.
+         *
+         * @tparam F a callable taking a 'size_t'.
+         *
+         * @param chunk the next bytes of the stream.
+         * @param on_match called with the offset of each occurrence from the start of the stream,
+         * in increasing order.
+         */
+        template<typename F>
+        void feed(std::string_view chunk, F &&on_match)
+        {
+                size_t carry_start = offset_ - carry_.length();
+
+                if (!carry_.empty())
+                {
+                        size_t carry_len = carry_.length();
+                        carry_.append(chunk.substr(0, key_.length() - 1));
+                        size_t pos = 0;
+                        while ((pos = carry_.find(key_, pos)) != std::string::npos && pos < carry_len)
+                        {
+                                on_match(carry_start + pos);
+                                matches_++;
+                                pos++;
+                        }
+                        carry_.resize(carry_len);
+                }
+
+                size_t pos = 0;
+                while ((pos = chunk.find(key_, pos)) != std::string_view::npos)
+                {
+                        on_match(offset_ + pos);
+                        matches_++;
+                        pos++;
+                }
+
+                offset_ += chunk.length();
+                size_t keep = key_.length() - 1;
+                if (chunk.length() >= keep)
+                {
+                        carry_.assign(chunk.substr(chunk.length() - keep));
+                }
+                else
+                {
+                        carry_.append(chunk);
+                        carry_.erase(0, carry_.length() - std::min(carry_.length(), keep));
+                }
+        }
+
+        /**
+         * Searches the next chunk of the stream, only counting occurrences.
+         *
+         * @param chunk the next bytes of the stream.
+         */
+        void feed(std::string_view chunk)
+        {
+                feed(chunk, [](size_t) {});
+        }
+
+        /**
+         * @return the number of occurrences found so far.
+         */
+        size_t matches() const
+        {
+                return matches_;
+        }
+
+        /**
+         * @return the number of bytes fed so far.
+         */
+        size_t offset() const
+        {
+                return offset_;
+        }
+
+private:
+        std::string key_;
+        std::string carry_;
+        size_t offset_ = 0;
+        size_t matches_ = 0;
+};
+
+/**
+ * Splits a stream fed one chunk at a time into substrings separated by a delimiter.
+ *
+ * Produces the same substrings 'split' would produce on the concatenation of all chunks, once
+ * 'finish' is called. Substrings that lie within one chunk are passed on as views into that chunk;
+ * only a substring or delimiter straddling a chunk boundary is copied.
+ *
+ * @see split
+ */
+class stream_splitter
+{
+public:
+        /**
+         * Creates a splitter for 'delimiter'.
+         *
+         * @param delimiter the string to split by.
+         *
+         * @throws std::invalid_argument Thrown if 'delimiter' is empty.
+         */
+        explicit stream_splitter(std::string_view delimiter)
+                : delimiter_(delimiter)
+        {
+                if (delimiter_.empty())
+                        STRH_THROW(std::invalid_argument("delimiter cannot be empty"));
+        }
+
+        /**
+         * Creates a splitter for 'delimiter'.
+         *
+         * @param delimiter the character to split by.
+         */
+        explicit stream_splitter(char delimiter)
+                : delimiter_(1, delimiter)
+        {
+        }
+
+        /**
+         * Splits the next chunk of the stream.
+         *
+         * @tparam F a callable taking a 'std::string_view' and a 'size_t'.
+         *
+         * @param chunk the next bytes of the stream.
+         * @param on_token called with each complete substring and the offset of its first byte from
+         * the start of the stream. The view is only valid during the call.
+         */
+        template<typename F>
+        void feed(std::string_view chunk, F &&on_token)
+        {
+                size_t pos = 0;
+
+                if (!partial_.empty())
+                {
+                        size_t straddle_end = find_straddling(chunk);
+                        if (straddle_end != std::string::npos)
+                        {
+                                on_token(std::string_view(partial_).substr(0, partial_.length() - delimiter_.length() + straddle_end),
+                                         token_start_);
+                                partial_.clear();
+                                pos = straddle_end;
+                                token_start_ = offset_ + pos;
+                        }
+                        else
+                        {
+                                size_t end = chunk.find(delimiter_);
+                                if (end == std::string_view::npos)
+                                {
+                                        partial_.append(chunk);
+                                        offset_ += chunk.length();
+                                        return;
+                                }
+
+                                partial_.append(chunk.substr(0, end));
+                                on_token(std::string_view(partial_), token_start_);
+                                partial_.clear();
+                                pos = end + delimiter_.length();
+                                token_start_ = offset_ + pos;
+                        }
+                }
+
+                size_t end;
+                while ((end = chunk.find(delimiter_, pos)) != std::string_view::npos)
+                {
+                        on_token(chunk.substr(pos, end - pos), offset_ + pos);
+                        pos = end + delimiter_.length();
+                }
+
+                token_start_ = offset_ + pos;
+                partial_.assign(chunk.substr(pos));
+                offset_ += chunk.length();
+        }
+
+        /**
+         * Ends the stream, passing on the last substring if it is not empty.
+         *
+         * @tparam F a callable taking a 'std::string_view' and a 'size_t'.
+         *
+         * @param on_token called with the last substring and its offset.
+         */
+        template<typename F>
+        void finish(F &&on_token)
+        {
+                if (!partial_.empty())
+                        on_token(std::string_view(partial_), token_start_);
+                partial_.clear();
+                token_start_ = offset_;
+        }
+
+        /**
+         * @return the number of bytes fed so far.
+         */
+        size_t offset() const
+        {
+                return offset_;
+        }
+
+private:
+        /**
+         * Finds a delimiter starting in 'partial_' and ending in 'chunk'.
+         *
+         * @return the index in 'chunk' just past the delimiter, or 'std::string::npos'.
+         */
+        size_t find_straddling(std::string_view chunk)
+        {
+                size_t tail_len = std::min(partial_.length(), delimiter_.length() - 1);
+                if (tail_len == 0)
+                        return std::string::npos;
+
+                scratch_.assign(partial_, partial_.length() - tail_len, tail_len);
+                scratch_.append(chunk.substr(0, delimiter_.length() - 1));
+                size_t found = scratch_.find(delimiter_);
+                if (found == std::string::npos || found >= tail_len)
+                        return std::string::npos;
+                return found + delimiter_.length() - tail_len;
+        }
+
+        std::string delimiter_;
+        std::string partial_;
+        std::string scratch_;
+        size_t token_start_ = 0;
+        size_t offset_ = 0;
+};
+}
+
+#endif //STRINGHELPERS_STREAM_H
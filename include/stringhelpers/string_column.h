@@ -0,0 +1,440 @@
+/**
+ * Columns of strings stored as one contiguous blob plus an offset array.
+ */
+
+#ifndef STRINGHELPERS_STRING_COLUMN_H
+#define STRINGHELPERS_STRING_COLUMN_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "stringhelpers/config.h"
+#include "stringhelpers/stringhelpers.h"
+
+namespace strh
+{
+
+/**
+ * A column of strings laid out like an Arrow string array: the bytes of every string back to back
+ * in one blob, and 'size() + 1' offsets where string 'i' is the bytes between 'offsets()[i]' and
+ * 'offsets()[i + 1]'.
+ *
+ * Adding a string appends to the blob and the offsets, so a column of millions of strings makes
+ * a few geometric reallocations instead of one allocation per string, and reading the column
+ * front to back streams through memory. The column functions below work on the whole column at
+ * once, mostly by scanning the blob.
+ *
+ * @tparam Offset the unsigned integer type of the offsets, which bounds the size of the blob.
+ */
+template<typename Offset>
+class basic_string_column
+{
+        static_assert(std::is_unsigned_v<Offset>, "string_column offsets must be unsigned");
+
+public:
+        using offset_type = Offset;
+
+        /**
+         * Iterates the strings of a column as 'std::string_view's.
+         */
+        class const_iterator
+        {
+        public:
+                using value_type = std::string_view;
+                using difference_type = std::ptrdiff_t;
+
+                const_iterator() = default;
+
+                std::string_view operator*() const
+                {
+                        return (*column_)[idx_];
+                }
+
+                const_iterator &operator++()
+                {
+                        idx_++;
+                        return *this;
+                }
+
+                const_iterator operator++(int)
+                {
+                        const_iterator ret = *this;
+                        idx_++;
+                        return ret;
+                }
+
+                bool operator==(const const_iterator &other) const
+                {
+                        return idx_ == other.idx_;
+                }
+
+        private:
+                friend class basic_string_column;
+
+                const_iterator(const basic_string_column *column, size_t idx)
+                        : column_(column), idx_(idx)
+                {
+                }
+
+                const basic_string_column *column_ = nullptr;
+                size_t idx_ = 0;
+        };
+
+        basic_string_column() = default;
+
+        /**
+         * Makes room for 'strings' strings of 'bytes' bytes in total.
+         *
+         * @param strings the number of strings to make room for.
+         * @param bytes the total length of the strings to make room for.
+         */
+        void reserve(size_t strings, size_t bytes)
+        {
+                offsets_.reserve(strings + 1);
+                blob_.reserve(bytes);
+        }
+
+        /**
+         * Appends 'string'.
+         *
+         * @param string the string to append.
+         *
+         * @throws std::length_error Thrown if the blob would outgrow 'Offset'.
+         */
+        void push_back(std::string_view string)
+        {
+                if (string.length() > std::numeric_limits<Offset>::max() - blob_.length())
+                        STRH_THROW(std::length_error("string_column blob does not fit its offsets"));
+
+                blob_.append(string);
+                offsets_.push_back(static_cast<Offset>(blob_.length()));
+        }
+
+        /**
+         * @return string 'idx', a view into the blob valid until the column is modified.
+         */
+        std::string_view operator[](size_t idx) const
+        {
+                return std::string_view(blob_).substr(offsets_[idx], offsets_[idx + 1] - offsets_[idx]);
+        }
+
+        size_t size() const
+        {
+                return offsets_.size() - 1;
+        }
+
+        bool empty() const
+        {
+                return size() == 0;
+        }
+
+        const_iterator begin() const
+        {
+                return {this, 0};
+        }
+
+        const_iterator end() const
+        {
+                return {this, size()};
+        }
+
+        /**
+         * @return the bytes of every string, back to back.
+         */
+        std::string_view blob() const
+        {
+                return blob_;
+        }
+
+        /**
+         * @return the 'size() + 1' offsets of the strings in the blob, starting with '0'.
+         */
+        std::span<const Offset> offsets() const
+        {
+                return offsets_;
+        }
+
+        void clear()
+        {
+                blob_.clear();
+                offsets_.resize(1);
+        }
+
+        /**
+         * Writes the column to 'out' as a small header, the offsets and the blob, each as raw bytes
+         * in native byte order.
+         *
+         * @param out the stream to write to.
+         */
+        void write(std::ostream &out) const
+        {
+                uint64_t header[3] = {magic, size(), blob_.length()};
+                out.write(reinterpret_cast<const char *>(header), sizeof(header));
+                out.write(reinterpret_cast<const char *>(offsets_.data()),
+                          static_cast<std::streamsize>(offsets_.size() * sizeof(Offset)));
+                out.write(blob_.data(), static_cast<std::streamsize>(blob_.length()));
+        }
+
+        /**
+         * Reads a column written by 'write' with the same 'Offset' type.
+         *
+         * @param in the stream to read from.
+         *
+         * @return the column read.
+         *
+         * @throws std::runtime_error Thrown if 'in' does not hold a valid column.
+         */
+        static basic_string_column read(std::istream &in)
+        {
+                uint64_t header[3];
+                if (!in.read(reinterpret_cast<char *>(header), sizeof(header)) || header[0] != magic
+                    || header[1] >= std::numeric_limits<Offset>::max() / sizeof(Offset)
+                    || header[2] > std::numeric_limits<Offset>::max())
+                        STRH_THROW(std::runtime_error("invalid string_column header"));
+
+                // A corrupt header must not allocate more than the stream can fill.
+                uint64_t length = (header[1] + 1) * sizeof(Offset) + header[2];
+                if (length < header[2] || length > remaining(in))
+                        STRH_THROW(std::runtime_error("truncated string_column"));
+
+                basic_string_column ret;
+                ret.offsets_.resize(header[1] + 1);
+                ret.blob_.resize(header[2]);
+                if (!in.read(reinterpret_cast<char *>(ret.offsets_.data()),
+                             static_cast<std::streamsize>(ret.offsets_.size() * sizeof(Offset)))
+                    || !in.read(ret.blob_.data(), static_cast<std::streamsize>(ret.blob_.length())))
+                        STRH_THROW(std::runtime_error("truncated string_column"));
+
+                if (ret.offsets_.front() != 0 || ret.offsets_.back() != header[2]
+                    || !std::is_sorted(ret.offsets_.begin(), ret.offsets_.end()))
+                        STRH_THROW(std::runtime_error("invalid string_column offsets"));
+                return ret;
+        }
+
+        /**
+         * Replaces every byte 'ch' of the blob with 'transform(ch)', keeping the offsets.
+         *
+         * @tparam F a callable taking and returning a 'char'.
+         *
+         * @param transform the function to apply to every byte.
+         */
+        template<typename F>
+        void transform_bytes(F &&transform)
+        {
+                for (char &ch: blob_)
+                        ch = transform(ch);
+        }
+
+private:
+        /**
+         * Returns the number of bytes left in 'in', or 'UINT64_MAX' if it cannot seek.
+         */
+        static uint64_t remaining(std::istream &in)
+        {
+                std::istream::pos_type pos = in.tellg();
+                if (pos == std::istream::pos_type(-1) || !in.seekg(0, std::ios::end))
+                {
+                        in.clear();
+                        return UINT64_MAX;
+                }
+                std::istream::pos_type end = in.tellg();
+                in.seekg(pos);
+                return static_cast<uint64_t>(end - pos);
+        }
+
+        /** "strcol" followed by the width of the offsets. */
+        static constexpr uint64_t magic = 0x6c6f63727473 | static_cast<uint64_t>(sizeof(Offset)) << 48;
+
+        std::string blob_;
+        std::vector<Offset> offsets_{0};
+};
+
+/** A string column with 32-bit offsets, for blobs up to 4 GiB. */
+using string_column = basic_string_column<uint32_t>;
+
+/** A string column with 64-bit offsets. */
+using large_string_column = basic_string_column<uint64_t>;
+
+/**
+ * Splits 'string' into substrings separated by 'delimiter', appending them to 'column'.
+ *
+ * Appends the same substrings 'split' returns, with at most one reallocation of the blob and of
+ * the offsets.
+ *
+ * @param string the string to split.
+ * @param delimiter the character to split 'string' by.
+ * @param column the column to append the substrings to.
+ *
+ * @see split(std::string_view, char)
+ */
+template<typename Offset>
+inline void split(std::string_view string, char delimiter, basic_string_column<Offset> &column)
+{
+        STRH_INSTRUMENT(split, string.length());
+        column.reserve(column.size() + count(string, delimiter) + 1, column.blob().length() + string.length());
+        size_t start = 0;
+        size_t end;
+        while ((end = string.find(delimiter, start)) != std::string_view::npos)
+        {
+                column.push_back(string.substr(start, end - start));
+                start = end + 1;
+        }
+
+        if (start < string.length())
+                column.push_back(string.substr(start));
+}
+
+/**
+ * Splits 'string' into substrings separated by '\n', appending them to 'column'.
+ *
+ * @param string the string to split.
+ * @param column the column to append the lines to.
+ *
+ * @see split_lines(std::string_view)
+ */
+template<typename Offset>
+inline void split_lines(std::string_view string, basic_string_column<Offset> &column)
+{
+        STRH_INSTRUMENT(split_lines, string.length());
+        split(string, '\n', column);
+}
+
+/**
+ * Counts the number of times 'key' is in each string of 'column'.
+ *
+ * Scans the blob once, attributing each occurrence to the string it falls in.
+ *
+ * @param column the strings to search.
+ * @param key the character to count the occurrences of.
+ *
+ * @return the count of every string, in order.
+ */
+template<typename Offset>
+inline std::vector<size_t> count(const basic_string_column<Offset> &column, char key)
+{
+        STRH_INSTRUMENT(count, column.blob().length());
+        std::vector<size_t> ret(column.size());
+        std::string_view blob = column.blob();
+        std::span<const Offset> offsets = column.offsets();
+        size_t idx = 0;
+        for (size_t pos = blob.find(key); pos != std::string_view::npos; pos = blob.find(key, pos + 1))
+        {
+                while (offsets[idx + 1] <= pos)
+                        idx++;
+                ret[idx]++;
+        }
+        return ret;
+}
+
+/**
+ * Checks, for each string of 'column', if all its characters are numbers.
+ *
+ * Reads the blob front to back.
+ *
+ * @param column the strings to check.
+ *
+ * @return whether each string is all numbers, in order. Empty strings give 'false'.
+ */
+template<typename Offset>
+inline std::vector<bool> all_nums(const basic_string_column<Offset> &column)
+{
+        STRH_INSTRUMENT(all_nums, column.blob().length());
+        std::vector<bool> ret(column.size());
+        const char *blob = column.blob().data();
+        std::span<const Offset> offsets = column.offsets();
+        for (size_t i = 0; i < column.size(); i++)
+        {
+                ret[i] = offsets[i] != offsets[i + 1]
+                         && std::all_of(blob + offsets[i], blob + offsets[i + 1], [](char ch) {
+                                    return ch >= '0' && ch <= '9';
+                            });
+        }
+        return ret;
+}
+
+/**
+ * Checks, for each string of 'column', if it starts with 'prefix'.
+ *
+ * @param column the strings to check.
+ * @param prefix the string to search for at the start of each string.
+ *
+ * @return whether each string starts with 'prefix', in order.
+ */
+template<typename Offset>
+inline std::vector<bool> starts_with(const basic_string_column<Offset> &column, std::string_view prefix)
+{
+        STRH_INSTRUMENT(starts_with, column.blob().length());
+        std::vector<bool> ret(column.size());
+        const char *blob = column.blob().data();
+        std::span<const Offset> offsets = column.offsets();
+        for (size_t i = 0; i < column.size(); i++)
+        {
+                ret[i] = offsets[i + 1] - offsets[i] >= prefix.length()
+                         && std::memcmp(blob + offsets[i], prefix.data(), prefix.length()) == 0;
+        }
+        return ret;
+}
+
+/**
+ * Converts every ASCII lowercase character of 'column' to uppercase.
+ *
+ * The lengths of the strings do not change, so the offsets are kept and the blob is converted in
+ * one pass.
+ *
+ * @param column the strings to convert.
+ *
+ * @return 'column' in uppercase.
+ *
+ * @note Works in place; does not allocate when 'column' is an rvalue.
+ */
+template<typename Offset>
+inline basic_string_column<Offset> to_upper(basic_string_column<Offset> column)
+{
+        STRH_INSTRUMENT(to_upper, column.blob().length());
+        column.transform_bytes([](char ch) {
+                return static_cast<char>(ch >= 'a' && ch <= 'z' ? ch - 'a' + 'A' : ch);
+        });
+        return column;
+}
+
+/**
+ * Removes whitespaces at the beginning and end of each string of 'column'.
+ *
+ * @param column the strings to remove white spaces of.
+ *
+ * @return a column of the stripped strings, in order.
+ *
+ * @note whitespaces are ' ', '\t'. '\n'.
+ * @note Allocates the blob and the offsets once each.
+ *
+ * @see strip(std::string)
+ */
+template<typename Offset>
+inline basic_string_column<Offset> strip(const basic_string_column<Offset> &column)
+{
+        STRH_INSTRUMENT(strip, column.blob().length());
+        basic_string_column<Offset> ret;
+        ret.reserve(column.size(), column.blob().length());
+        for (std::string_view string: column)
+        {
+                size_t front = string.find_first_not_of(" \t\n");
+                if (front == std::string_view::npos)
+                        ret.push_back({});
+                else
+                        ret.push_back(string.substr(front, string.find_last_not_of(" \t\n") - front + 1));
+        }
+        return ret;
+}
+}
+
+#endif //STRINGHELPERS_STRING_COLUMN_H
@@ -5,9 +5,28 @@
 #ifndef STRINGHELPERS_STRINGHELPERS_H
 #define STRINGHELPERS_STRINGHELPERS_H
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
-#include <sstream>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "stringhelpers/config.h"
+#include "stringhelpers/hash.h"
+#include "stringhelpers/stats.h"
 
 namespace strh
 {
@@ -20,42 +39,51 @@ namespace strh
 enum Alignment { LEFT, CENTER, RIGHT };
 
 /**
- * Capitalizes 'string'.
- *
- * Capitalizes the first character in 'string'.
+ * The errors reported by the 'strh::nx' functions.
  *
- * @param string the string to capitalize
+ * The 'strh::nx' namespace holds a non-throwing version of every strh function that can fail.
+ * Instead of throwing 'std::invalid_argument', they return the error in a 'std::expected', so they
+ * can be used in code built with '-fno-exceptions' and on paths where a throw is too expensive. The
+ * throwing functions are thin wrappers over them. Running out of memory still terminates.
  *
- * @return capitalized 'string'.
+ * @see error_message
  */
-inline std::string capitalize(std::string string)
+enum class errc
 {
-        string[0] = static_cast<char>(toupper(string[0]));
-        return string;
-}
+        empty_key, empty_string, empty_fill, empty_delimiter, invalid_alignment, missing_field,
+        invalid_field
+};
 
 /**
- * Multiply 'string'.
+ * Describes 'error'.
  *
- * @param string the string to multiply.
- * @param amount the amount of times to multiply 'string'.
+ * @param error the error to describe.
  *
- * @return multiplied 'string'
+ * @return the message the throwing functions use for 'error'.
  */
-inline std::string multiply(std::string string, size_t amount)
+constexpr const char *error_message(errc error) noexcept
 {
-        std::string multiplied_string;
-        while (amount > 0)
-        {
-                multiplied_string += string;
-                amount--;
+        switch (error) {
+        case errc::empty_key:
+                return "key cannot be empty";
+        case errc::empty_string:
+                return "string cannot be empty";
+        case errc::empty_fill:
+                return "fill cannot be empty";
+        case errc::empty_delimiter:
+                return "delimiter cannot be empty";
+        case errc::invalid_alignment:
+                return "Invalid alignment";
+        case errc::missing_field:
+                return "record has too few fields";
+        case errc::invalid_field:
+                return "field cannot be parsed";
         }
-        string = multiplied_string;
-        return string;
+        return "unknown error";
 }
 
 /**
- * Helper functions for the String Helper functions.
+ * Helper functions for the throwing wrappers of the 'strh::nx' functions.
  *
  * @relatealso strh
  */
@@ -63,54 +91,389 @@ namespace priv_helpers
 {
 
 /**
- * Adds characters to the left of 'string' to align 'string' to a target length.
+ * The classification functions of <cctype> for the all_* functions. They are not constexpr, so in
+ * constant expressions ASCII is classified like the "C" locale instead.
+ */
+constexpr bool is_digit(char ch)
+{
+        if (std::is_constant_evaluated())
+                return ch >= '0' && ch <= '9';
+        return isdigit(ch);
+}
+
+constexpr bool is_alpha(char ch)
+{
+        if (std::is_constant_evaluated())
+                return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+        return isalpha(ch);
+}
+
+constexpr bool is_lower(char ch)
+{
+        if (std::is_constant_evaluated())
+                return ch >= 'a' && ch <= 'z';
+        return islower(ch);
+}
+
+constexpr bool is_upper(char ch)
+{
+        if (std::is_constant_evaluated())
+                return ch >= 'A' && ch <= 'Z';
+        return isupper(ch);
+}
+
+constexpr bool is_space(char ch)
+{
+        if (std::is_constant_evaluated())
+                return ch == ' ' || (ch >= '\t' && ch <= '\r');
+        return isspace(ch);
+}
+
+/**
+ * Returns the value of 'result', or throws 'std::invalid_argument' with its error message.
+ */
+template<typename T>
+constexpr T value_or_throw(std::expected<T, errc> &&result)
+{
+        if (!result)
+                STRH_THROW(std::invalid_argument(error_message(result.error())));
+        return std::move(*result);
+}
+}
+
+/**
+ * Capitalizes 'string'.
  *
- * @param string the string to align.
- * @param target_len the length to set 'string' to.
- * @param fill the character to add to 'string' to align it.
+ * Capitalizes the first character in 'string'.
  *
- * @return 'string' aligned to the left.
+ * @param string the string to capitalize
+ *
+ * @return capitalized 'string'.
+ *
+ * @note Works in place; does not allocate when 'string' is an rvalue.
  */
-inline std::string align_left(std::string string, size_t target_len, std::string fill)
+inline std::string capitalize(std::string string)
 {
-        size_t fill_amount = target_len - string.length();
-        fill = strh::multiply(fill, fill_amount / fill.size());
-        string = fill + string;
+        STRH_INSTRUMENT(capitalize, string.length());
+        string[0] = static_cast<char>(toupper(string[0]));
         return string;
 }
 
 /**
- * Adds characters to the right of 'string' to align 'string' to a target length.
+ * Builds a string in a single growing buffer.
  *
- * @param string the string to align.
- * @param target_len the length to set 'string' to.
- * @param fill the character to add to 'string' to align it.
+ * Capacity grows geometrically, and every append that knows its final size up front reserves it
+ * once, so building a string from many pieces does not reallocate on every piece.
+ */
+class builder
+{
+public:
+        builder() = default;
+
+        /**
+         * Creates a builder with room for 'capacity' characters.
+         *
+         * @param capacity the number of characters to reserve.
+         */
+        explicit builder(size_t capacity)
+        {
+                buffer_.reserve(capacity);
+        }
+
+        /**
+         * Ensures at least 'capacity' characters fit without reallocating.
+         *
+         * @param capacity the number of characters to reserve.
+         */
+        void reserve(size_t capacity)
+        {
+                buffer_.reserve(capacity);
+        }
+
+        /**
+         * Appends 'string'.
+         *
+         * @param string the string to append.
+         *
+         * @return this builder.
+         */
+        builder &append(std::string_view string)
+        {
+                grow(string.length(), string);
+                buffer_.append(string);
+                return *this;
+        }
+
+        /**
+         * Appends 'ch'.
+         *
+         * @param ch the character to append.
+         *
+         * @return this builder.
+         */
+        builder &append(char ch)
+        {
+                grow(1);
+                buffer_.push_back(ch);
+                return *this;
+        }
+
+        /**
+         * Appends 'ch' 'amount' times.
+         *
+         * @param ch the character to append.
+         * @param amount the amount of times to append 'ch'.
+         *
+         * @return this builder.
+         */
+        builder &append_n(char ch, size_t amount)
+        {
+                grow(amount);
+                buffer_.append(amount, ch);
+                return *this;
+        }
+
+        /**
+         * Appends 'string' 'amount' times.
+         *
+         * 'string' is copied once, after which the copied region is doubled with memcpy until
+         * 'amount' copies are written, so large amounts take O(log amount) copies.
+         *
+         * @param string the string to append.
+         * @param amount the amount of times to append 'string'.
+         *
+         * @return this builder.
+         *
+         * @throws std::length_error Thrown if the result would be longer than 'max_size'.
+         */
+        builder &append_repeat(std::string_view string, size_t amount)
+        {
+                if (string.empty() || amount == 0)
+                        return *this;
+                if (string.length() == 1)
+                        return append_n(string[0], amount);
+                if (amount > (buffer_.max_size() - buffer_.length()) / string.length())
+                        STRH_THROW(std::length_error("repeated string is too long"));
+
+                size_t total = string.length() * amount;
+                size_t start = buffer_.length();
+                grow(total, string);
+                buffer_.resize(start + total);
+
+                char *out = buffer_.data() + start;
+                std::memcpy(out, string.data(), string.length());
+                size_t written = string.length();
+                while (written < total)
+                {
+                        size_t chunk = std::min(written, total - written);
+                        std::memcpy(out + written, out, chunk);
+                        written += chunk;
+                }
+                return *this;
+        }
+
+        /**
+         * Appends 'string' aligned to a target length with 'fill'.
+         *
+         * Writes exactly what 'strh::align' returns for the same arguments.
+         *
+         * @param string the string to append.
+         * @param alignment which side(s) to align 'string' to.
+         * @param target_len the length to align 'string' to.
+         * @param fill the string to add to 'string' to align it.
+         *
+         * @return this builder.
+         *
+         * @throws std::invalid_argument Thrown if 'fill' is empty.
+         *
+         * @see align
+         */
+        builder &append_aligned(std::string_view string, Alignment alignment, size_t target_len,
+                                std::string_view fill)
+        {
+                if (fill.empty())
+                        STRH_THROW(std::invalid_argument("fill cannot be empty"));
+
+                size_t fill_amount = target_len > string.length() ? target_len - string.length() : 0;
+                size_t fill_count = fill_amount / fill.length();
+
+                switch (alignment) {
+                case LEFT:
+                        grow(fill_count * fill.length() + string.length(), string, fill);
+                        append_repeat(fill, fill_count);
+                        return append(string);
+                case CENTER:
+                        fill_count /= 2;
+                        grow(2 * fill_count * fill.length() + string.length(), string, fill);
+                        append_repeat(fill, fill_count);
+                        append(string);
+                        return append_repeat(fill, fill_count);
+                case RIGHT:
+                        grow(fill_count * fill.length() + string.length(), string, fill);
+                        append(string);
+                        return append_repeat(fill, fill_count);
+                default:
+                        STRH_THROW(std::invalid_argument("Invalid alignment"));
+                }
+        }
+
+        /**
+         * Appends the decimal representation of 'number'.
+         *
+         * @tparam T the arithmetic type of 'number'.
+         *
+         * @param number the number to append.
+         *
+         * @return this builder.
+         */
+        template<typename T>
+        requires std::is_arithmetic_v<T>
+        builder &append_number(T number)
+        {
+                // Longest output of to_chars for doubles in the shortest round-trip form.
+                constexpr size_t max_len = 32;
+                size_t start = buffer_.length();
+                grow(max_len);
+                buffer_.resize(start + max_len);
+                auto result = std::to_chars(buffer_.data() + start, buffer_.data() + start + max_len,
+                                            number);
+                buffer_.resize(result.ptr - buffer_.data());
+                return *this;
+        }
+
+        /**
+         * @return the number of characters appended so far.
+         */
+        size_t length() const
+        {
+                return buffer_.length();
+        }
+
+        /**
+         * @return the number of characters that fit without reallocating.
+         */
+        size_t capacity() const
+        {
+                return buffer_.capacity();
+        }
+
+        /**
+         * Removes all characters, keeping the capacity.
+         */
+        void clear()
+        {
+                buffer_.clear();
+        }
+
+        /**
+         * @return a view of the characters appended so far.
+         */
+        std::string_view view() const
+        {
+                return buffer_;
+        }
+
+        /**
+         * Moves the built string out of the builder, leaving it empty.
+         *
+         * @return the built string.
+         */
+        std::string str()
+        {
+                return std::move(buffer_);
+        }
+
+private:
+        /**
+         * Makes room for 'extra' more characters, at least doubling the capacity when growing.
+         *
+         * Any of 'sources' viewing the buffer itself is moved to the new buffer, so appending a
+         * view of the builder to itself stays valid after a reallocation.
+         */
+        template<typename... Views>
+        void grow(size_t extra, Views &...sources)
+        {
+                size_t needed = buffer_.length() + extra;
+                if (needed <= buffer_.capacity())
+                        return;
+
+                std::array<size_t, sizeof...(Views)> offsets{offset_in_buffer(sources)...};
+                buffer_.reserve(std::max(needed, buffer_.capacity() * 2));
+                if constexpr (sizeof...(Views) > 0)
+                {
+                        size_t i = 0;
+                        auto move = [&](std::string_view &source) {
+                                if (offsets[i] != std::string_view::npos)
+                                        source = {buffer_.data() + offsets[i], source.length()};
+                                i++;
+                        };
+                        (move(sources), ...);
+                }
+        }
+
+        /**
+         * Returns the position of 'string' in the buffer, or 'std::string_view::npos' if it does
+         * not point into it.
+         */
+        size_t offset_in_buffer(std::string_view string) const
+        {
+                const char *begin = buffer_.data();
+                const char *end = begin + buffer_.length();
+                // 'std::less' orders unrelated pointers, unlike the built-in comparisons.
+                std::less<const char *> less;
+                if (!less(string.data(), begin) && less(string.data(), end))
+                        return static_cast<size_t>(string.data() - begin);
+                return std::string_view::npos;
+        }
+
+        std::string buffer_;
+};
+
+/**
+ * Multiply 'string'.
+ *
+ * @param string the string to multiply.
+ * @param amount the amount of times to multiply 'string'.
  *
- * @return 'string' aligned to the right.
+ * @return multiplied 'string'
+ *
+ * @throws std::length_error Thrown if the result would be longer than 'std::string::max_size'.
+ *
+ * @note Allocates at most once.
  */
-inline std::string align_center(std::string string, size_t target_len, std::string fill)
+inline std::string multiply(std::string_view string, size_t amount)
 {
-        size_t fill_amount = target_len - string.length();
-        fill = strh::multiply(fill, (fill_amount / fill.size()) / 2);
-        string = fill + string + fill;
-        return string;
+        STRH_INSTRUMENT(multiply, string.length());
+        if (!string.empty() && amount > std::string().max_size() / string.length())
+                STRH_THROW(std::length_error("multiplied string is too long"));
+        builder multiplied_string(string.length() * amount);
+        multiplied_string.append_repeat(string, amount);
+        return multiplied_string.str();
 }
 
+namespace nx
+{
+
 /**
- * Adds characters to the left and right of 'string' to align 'string' to a target length.
+ * Non-throwing 'strh::align'.
  *
- * @param string the string to align.
- * @param target_len the length to set 'string' to.
- * @param fill the character to add to 'string' to align it.
+ * @return aligned 'string', or 'errc::empty_fill' if 'fill' is empty and 'errc::invalid_alignment'
+ * if 'alignment' is not an 'Alignment'.
  *
- * @return 'string' aligned to the center.
+ * @note Allocation failures still throw, as in 'strh::align'.
  */
-inline std::string align_right(std::string string, size_t target_len, std::string fill)
+inline std::expected<std::string, errc> align(std::string_view string, Alignment alignment,
+                                              size_t target_len, std::string_view fill)
 {
-        size_t fill_amount = target_len - string.length();
-        fill = strh::multiply(fill, fill_amount / fill.size());
-        string = string + fill;
-        return string;
+        STRH_INSTRUMENT(align, string.length());
+        if (fill.empty())
+                return std::unexpected(errc::empty_fill);
+        if (alignment != LEFT && alignment != CENTER && alignment != RIGHT)
+                return std::unexpected(errc::invalid_alignment);
+
+        builder aligned_string;
+        aligned_string.append_aligned(string, alignment, target_len, fill);
+        return aligned_string.str();
 }
 }
 
@@ -122,24 +485,17 @@ inline std::string align_right(std::string string, size_t target_len, std::strin
  * @param target_len the length to set 'string' to.
  * @param fill the character to add to 'string' to align it.
  *
- * @return aligned 'string'.
+ * @return aligned 'string'. If 'string' is already at least 'target_len' long, 'string' is
+ * returned unchanged.
+ *
+ * @throws std::invalid_argument Thrown if 'fill' is empty.
+ *
+ * @note Allocates at most once.
  */
-inline std::string align(std::string string, Alignment alignment, size_t target_len,
-                  const std::string &fill)
+inline std::string align(std::string_view string, Alignment alignment, size_t target_len,
+                  std::string_view fill)
 {
-        if (fill.empty())
-                throw std::invalid_argument("fill cannot be empty");
-
-        switch (alignment) {
-        case LEFT:
-                return strh::priv_helpers::align_left(std::move(string), target_len, fill);
-        case CENTER:
-                return priv_helpers::align_center(std::move(string), target_len, fill);
-        case RIGHT:
-                return priv_helpers::align_right(std::move(string), target_len, fill);
-        default:
-                throw std::invalid_argument("Invalid alignment");
-        }
+        return priv_helpers::value_or_throw(nx::align(string, alignment, target_len, fill));
 }
 
 /**
@@ -150,13 +506,12 @@ inline std::string align(std::string string, Alignment alignment, size_t target_
  * @param target_len the length to set 'string' to.
  * @param fill the character to add to 'string' to align it.
  *
- * @return aligned 'string'.
- *
- * @throws std::invalid_argument Thrown if 'fill' is empty.
+ * @return aligned 'string'. If 'string' is already at least 'target_len' long, 'string' is
+ * returned unchanged.
  */
-inline std::string align(std::string string, Alignment alignment, size_t target_len, char fill)
+inline std::string align(std::string_view string, Alignment alignment, size_t target_len, char fill)
 {
-        return align(std::move(string), alignment, target_len, std::string(1, fill));
+        return align(string, alignment, target_len, std::string_view(&fill, 1));
 }
 
 
@@ -168,9 +523,10 @@ inline std::string align(std::string string, Alignment alignment, size_t target_
  *
  * @return the number of times 'key' is in 'string'.
  */
-inline size_t count(std::string_view string, char key)
+constexpr size_t count(std::string_view string, char key)
 {
-        int ret = 0;
+        STRH_INSTRUMENT(count, string.length());
+        size_t ret = 0;
         for (char ch: string)
         {
                 if (ch == key)
@@ -179,6 +535,31 @@ inline size_t count(std::string_view string, char key)
         return ret;
 }
 
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::count'.
+ *
+ * @return the number of times 'key' is in 'string', or 'errc::empty_key' if 'key' is empty.
+ */
+constexpr std::expected<size_t, errc> count(std::string_view string, std::string_view key) noexcept
+{
+        STRH_INSTRUMENT(count, string.length());
+        if (key.empty())
+                return std::unexpected(errc::empty_key);
+
+        size_t ret = 0;
+        size_t pos = 0;
+        while ((pos = string.find(key, pos)) != std::string::npos)
+        {
+                ret++;
+                pos += key.length();
+        }
+        return ret;
+}
+}
+
 /**
  * Counts the number of times 'key' is in 'string'
  *
@@ -189,21 +570,179 @@ inline size_t count(std::string_view string, char key)
  *
  * @throws std::invalid_argument Thrown if 'key' is empty.
  */
-inline size_t count(std::string_view string, std::string_view key)
+constexpr size_t count(std::string_view string, std::string_view key)
 {
-        if (key.empty())
-                throw std::invalid_argument("key cannot be empty");
+        return priv_helpers::value_or_throw(nx::count(string, key));
+}
+
+/**
+ * Counts every byte value of 'string' in one pass.
+ *
+ * Bytes are read 8 at a time and counted into four interleaved tables, so consecutive bytes of the
+ * same value increment different counters instead of each waiting on the store of the one before.
+ *
+ * @param string the string to count the bytes of.
+ *
+ * @return the number of times each byte value is in 'string', indexed by the byte as an
+ * 'unsigned char'.
+ */
+inline std::array<size_t, 256> histogram(std::string_view string)
+{
+        STRH_INSTRUMENT(histogram, string.length());
+        std::array<size_t, 256> ret{};
+        const char *data = string.data();
+        uint32_t tables[4][256];
+        size_t pos = 0;
+        while (pos < string.length())
+        {
+                // Each table takes at most a quarter of the chunk, which keeps its counters in 32 bits.
+                size_t end = pos + std::min<size_t>(string.length() - pos, UINT32_MAX);
+                std::memset(tables, 0, sizeof(tables));
+                for (; pos + 8 <= end; pos += 8)
+                {
+                        uint64_t word;
+                        std::memcpy(&word, data + pos, sizeof(word));
+                        tables[0][word & 0xff]++;
+                        tables[1][(word >> 8) & 0xff]++;
+                        tables[2][(word >> 16) & 0xff]++;
+                        tables[3][(word >> 24) & 0xff]++;
+                        tables[0][(word >> 32) & 0xff]++;
+                        tables[1][(word >> 40) & 0xff]++;
+                        tables[2][(word >> 48) & 0xff]++;
+                        tables[3][word >> 56]++;
+                }
+                for (; pos < end; pos++)
+                        tables[0][static_cast<unsigned char>(data[pos])]++;
+
+                for (size_t i = 0; i < 256; i++)
+                        ret[i] += size_t(tables[0][i]) + tables[1][i] + tables[2][i] + tables[3][i];
+        }
+        return ret;
+}
+
+namespace priv_helpers
+{
+
+#if defined(__SSE2__)
+/**
+ * Adds the number of times each of the 'K' characters of 'keys' is in 'string' to 'counts'.
+ *
+ * Every block of 16 bytes is compared with all the keys while it is in a register. Matches are
+ * accumulated in per-byte counters, which are summed every 255 blocks before they can overflow.
+ */
+template<size_t K>
+inline void count_any_sse2(std::string_view string, std::string_view keys, size_t *counts)
+{
+        __m128i needles[K];
+        for (size_t k = 0; k < K; k++)
+                needles[k] = _mm_set1_epi8(keys[k]);
 
-        int ret = 0;
+        const char *data = string.data();
         size_t pos = 0;
-        while ((pos = string.find(key, pos)) != std::string::npos)
+        while (pos + 16 <= string.length())
         {
-                ret++;
-                pos += key.length();
+                size_t end = pos + std::min<size_t>((string.length() - pos) / 16, 255) * 16;
+                __m128i sums[K];
+                for (size_t k = 0; k < K; k++)
+                        sums[k] = _mm_setzero_si128();
+                for (; pos < end; pos += 16)
+                {
+                        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+                        for (size_t k = 0; k < K; k++)
+                                sums[k] = _mm_sub_epi8(sums[k], _mm_cmpeq_epi8(block, needles[k]));
+                }
+                for (size_t k = 0; k < K; k++)
+                {
+                        __m128i total = _mm_sad_epu8(sums[k], _mm_setzero_si128());
+                        counts[k] += static_cast<size_t>(_mm_cvtsi128_si32(total))
+                                     + static_cast<size_t>(_mm_cvtsi128_si32(_mm_srli_si128(total, 8)));
+                }
+        }
+
+        for (; pos < string.length(); pos++)
+        {
+                for (size_t k = 0; k < K; k++)
+                        counts[k] += data[pos] == keys[k];
+        }
+}
+#endif
+}
+
+/**
+ * Counts the number of times each character of 'keys' is in 'string', reading 'string' once.
+ *
+ * Up to 8 keys are compared with every block of 16 bytes at once; more keys are read from a
+ * 'histogram' of 'string'.
+ *
+ * @param string the string to search.
+ * @param keys the characters to count the occurrences of.
+ *
+ * @return the number of times each character of 'keys' is in 'string', in the order of 'keys'.
+ *
+ * @note Allocates once.
+ *
+ * @see count(std::string_view, char)
+ */
+inline std::vector<size_t> count_any(std::string_view string, std::string_view keys)
+{
+        STRH_INSTRUMENT(count_any, string.length());
+        std::vector<size_t> ret(keys.length());
+#if defined(__SSE2__)
+        switch (keys.length()) {
+        case 0:
+                return ret;
+        case 1:
+                priv_helpers::count_any_sse2<1>(string, keys, ret.data());
+                return ret;
+        case 2:
+                priv_helpers::count_any_sse2<2>(string, keys, ret.data());
+                return ret;
+        case 3:
+                priv_helpers::count_any_sse2<3>(string, keys, ret.data());
+                return ret;
+        case 4:
+                priv_helpers::count_any_sse2<4>(string, keys, ret.data());
+                return ret;
+        case 5:
+                priv_helpers::count_any_sse2<5>(string, keys, ret.data());
+                return ret;
+        case 6:
+                priv_helpers::count_any_sse2<6>(string, keys, ret.data());
+                return ret;
+        case 7:
+                priv_helpers::count_any_sse2<7>(string, keys, ret.data());
+                return ret;
+        case 8:
+                priv_helpers::count_any_sse2<8>(string, keys, ret.data());
+                return ret;
+        default:
+                break;
         }
+#endif
+        std::array<size_t, 256> counts = histogram(string);
+        for (size_t k = 0; k < keys.length(); k++)
+                ret[k] = counts[static_cast<unsigned char>(keys[k])];
         return ret;
 }
 
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::ends_with'.
+ *
+ * @return whether 'string' ends with 'key', or 'errc::empty_string' if 'string' is empty.
+ */
+constexpr std::expected<bool, errc> ends_with(std::string_view string, char key) noexcept
+{
+        STRH_INSTRUMENT(ends_with, string.length());
+        if (string.empty())
+                return std::unexpected(errc::empty_string);
+
+        return string[string.length() - 1] == key;
+}
+}
+
 /**
  * Checks if 'string' ends with 'key'.
  *
@@ -214,12 +753,9 @@ inline size_t count(std::string_view string, std::string_view key)
  *
  * @throw std::invalid_argument Thrown if 'string' is empty.
  */
-inline bool ends_with(std::string_view string, char key)
+constexpr bool ends_with(std::string_view string, char key)
 {
-        if (string.empty())
-                throw std::invalid_argument("string cannot be empty");
-
-        return string[string.length() - 1] == key;
+        return priv_helpers::value_or_throw(nx::ends_with(string, key));
 }
 
 /**
@@ -230,10 +766,28 @@ inline bool ends_with(std::string_view string, char key)
  *
  * @return 'true' if 'string' ends with 'key', 'false' otherwise.
  */
-inline bool ends_with(std::string_view string, std::string_view key)
+constexpr bool ends_with(std::string_view string, std::string_view key)
+{
+        STRH_INSTRUMENT(ends_with, string.length());
+        return string.length() >= key.length() && string.substr(string.length() - key.length()) == key;
+}
+
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::starts_with'.
+ *
+ * @return whether 'string' starts with 'key', or 'errc::empty_string' if 'string' is empty.
+ */
+constexpr std::expected<bool, errc> starts_with(std::string_view string, char key) noexcept
 {
-        size_t start_idx = string.length() - key.length();
-        return string.substr(start_idx, key.length()) == key;
+        STRH_INSTRUMENT(starts_with, string.length());
+        if (string.empty())
+                return std::unexpected(errc::empty_string);
+
+        return string[0] == key;
+}
 }
 
 /**
@@ -246,12 +800,9 @@ inline bool ends_with(std::string_view string, std::string_view key)
  *
  * @throw std::invalid_argument Thrown if 'string' is empty.
  */
-inline bool starts_with(std::string_view string, char key)
+constexpr bool starts_with(std::string_view string, char key)
 {
-    if (string.empty())
-        throw std::invalid_argument("string cannot be empty");
-
-    return string[0] == key;
+        return priv_helpers::value_or_throw(nx::starts_with(string, key));
 }
 
 /**
@@ -262,8 +813,9 @@ inline bool starts_with(std::string_view string, char key)
  *
  * @return 'true' if 'string' starts with 'key', 'false' otherwise.
  */
-inline bool starts_with(std::string_view string, std::string_view prefix)
+constexpr bool starts_with(std::string_view string, std::string_view prefix)
 {
+    STRH_INSTRUMENT(starts_with, string.length());
     if (string.length() < prefix.length())
         return false;
 
@@ -278,11 +830,30 @@ inline bool starts_with(std::string_view string, std::string_view prefix)
  *
  * @return 'true' if 'key' is in 'string', 'false' otherwise.
  */
-inline bool is_in(std::string_view string, char key)
+constexpr bool is_in(std::string_view string, char key)
 {
+        STRH_INSTRUMENT(is_in, string.length());
         return count(string, key) != 0;
 }
 
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::is_in'.
+ *
+ * @return whether 'key' is in 'string', or 'errc::empty_key' if 'key' is empty.
+ */
+constexpr std::expected<bool, errc> is_in(std::string_view string, std::string_view key) noexcept
+{
+        STRH_INSTRUMENT(is_in, string.length());
+        if (key.empty())
+                return std::unexpected(errc::empty_key);
+
+        return string.find(key) != std::string_view::npos;
+}
+}
+
 /**
  * Checks if 'key' is in 'string'.
  *
@@ -290,38 +861,76 @@ inline bool is_in(std::string_view string, char key)
  * @param key the string to search for in 'string'.
  *
  * @return 'true' if 'key' is in 'string', 'false' otherwise.
+ *
+ * @throws std::invalid_argument Thrown if 'key' is empty.
  */
-inline bool is_in(std::string_view string, std::string_view key)
+constexpr bool is_in(std::string_view string, std::string_view key)
 {
-        return count(string, key) != 0;
+        return priv_helpers::value_or_throw(nx::is_in(string, key));
 }
 
+namespace nx
+{
+
 /**
- * Checks if all characters in 'string' are numbers.
- *
- * @param string the string to check.
- *
- * @return 'true' if all characters in 'string' are numbers, 'false' otherwise or if 'string' is
- * empty.
+ * Non-throwing 'strh::all_nums'.
  *
- * @throw std::invalid_argument Thrown if 'string' is empty.
+ * @return whether all characters in 'string' are numbers, or 'errc::empty_string' if 'string'
+ * is empty.
  */
-inline bool all_nums(std::string_view string)
+constexpr std::expected<bool, errc> all_nums(std::string_view string) noexcept
 {
+        STRH_INSTRUMENT(all_nums, string.length());
         if (string.empty())
-                throw std::invalid_argument("string cannot be empty");
+                return std::unexpected(errc::empty_string);
 
         for (char ch: string)
         {
-                if (!isdigit(ch))
+                if (!priv_helpers::is_digit(ch))
                         return false;
         }
+        return true;
+}
+}
 
+/**
+ * Checks if all characters in 'string' are numbers.
+ *
+ * @param string the string to check.
+ *
+ * @return 'true' if all characters in 'string' are numbers, 'false' otherwise or if 'string' is
+ * empty.
+ *
+ * @throw std::invalid_argument Thrown if 'string' is empty.
+ */
+constexpr bool all_nums(std::string_view string)
+{
+        return priv_helpers::value_or_throw(nx::all_nums(string));
+}
+
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::all_alphabetical'.
+ *
+ * @return whether all characters in 'string' are alphabetical (letters), or 'errc::empty_string' if 'string'
+ * is empty.
+ */
+constexpr std::expected<bool, errc> all_alphabetical(std::string_view string) noexcept
+{
+        STRH_INSTRUMENT(all_alphabetical, string.length());
         if (string.empty())
-                return false;
+                return std::unexpected(errc::empty_string);
 
+        for (char ch: string)
+        {
+                if (!priv_helpers::is_alpha(ch))
+                        return false;
+        }
         return true;
 }
+}
 
 /**
  * Checks if all characters in 'string' are alphabetical (letters).
@@ -333,24 +942,34 @@ inline bool all_nums(std::string_view string)
  *
  * @throw std::invalid_argument Thrown if 'string' is empty.
  */
-inline bool all_alphabetical(std::string_view string)
+constexpr bool all_alphabetical(std::string_view string)
+{
+        return priv_helpers::value_or_throw(nx::all_alphabetical(string));
+}
+
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::all_lowercase'.
+ *
+ * @return whether all characters in 'string' are lowercase, or 'errc::empty_string' if 'string'
+ * is empty.
+ */
+constexpr std::expected<bool, errc> all_lowercase(std::string_view string) noexcept
 {
+        STRH_INSTRUMENT(all_lowercase, string.length());
         if (string.empty())
-        {
-                throw std::invalid_argument("string cannot be empty");
-        }
+                return std::unexpected(errc::empty_string);
 
         for (char ch: string)
         {
-                if (!isalpha(ch))
+                if (!priv_helpers::is_lower(ch))
                         return false;
         }
-
-        if (string.empty())
-                return false;
-
         return true;
 }
+}
 
 /**
  * Checks if all characters in 'string' are lowercase.
@@ -362,289 +981,904 @@ inline bool all_alphabetical(std::string_view string)
  *
  * @throw std::invalid_argument Thrown if 'string' is empty.
  */
-inline bool all_lowercase(std::string_view string)
+constexpr bool all_lowercase(std::string_view string)
+{
+        return priv_helpers::value_or_throw(nx::all_lowercase(string));
+}
+
+namespace nx
 {
+
+/**
+ * Non-throwing 'strh::all_uppercase'.
+ *
+ * @return whether all characters in 'string' are uppercase, or 'errc::empty_string' if 'string'
+ * is empty.
+ */
+constexpr std::expected<bool, errc> all_uppercase(std::string_view string) noexcept
+{
+        STRH_INSTRUMENT(all_uppercase, string.length());
         if (string.empty())
-                throw std::invalid_argument("string cannot be empty");
+                return std::unexpected(errc::empty_string);
 
         for (char ch: string)
         {
-                if (!islower(ch))
+                if (!priv_helpers::is_upper(ch))
                         return false;
         }
+        return true;
+}
+}
 
+/**
+ * Checks if all characters in 'string' are uppercase.
+ *
+ * @param string the string to check.
+ *
+ * @return 'true' if all characters in 'string' are uppercase, 'false' otherwise or if 'string' is
+ * empty.
+ *
+ * @throw std::invalid_argument Thrown if 'string' is empty.
+ */
+constexpr bool all_uppercase(std::string_view string)
+{
+        return priv_helpers::value_or_throw(nx::all_uppercase(string));
+}
+
+
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::all_spaces'.
+ *
+ * @return whether all characters in 'string' are spaces, or 'errc::empty_string' if 'string'
+ * is empty.
+ */
+constexpr std::expected<bool, errc> all_spaces(std::string_view string) noexcept
+{
+        STRH_INSTRUMENT(all_spaces, string.length());
         if (string.empty())
-                return false;
+                return std::unexpected(errc::empty_string);
 
+        for (char ch: string)
+        {
+                if (!priv_helpers::is_space(ch))
+                        return false;
+        }
         return true;
 }
+}
+
+/**
+ * Checks if all characters in 'string' are spaces.
+ *
+ * @param string the string to check.
+ *
+ * @return 'true' if all characters in 'string' are spaces, 'false' otherwise or if 'string' is
+ * empty.
+ *
+ * @throw std::invalid_argument Thrown if 'string' is empty.
+ */
+constexpr bool all_spaces(std::string_view string)
+{
+        return priv_helpers::value_or_throw(nx::all_spaces(string));
+}
+
+/**
+ * Splits 'string' into substrings separated by 'delimiter'.
+ *
+ * @param string the string to split.
+ * @param delimiter the character to split 'string' by.
+ *
+ * @return a vector of the substrings of 'string'.
+ *
+ * @note Allocates the vector once, plus once per substring too long for the small string buffer.
+ */
+constexpr std::vector<std::string> split(std::string_view string, char delimiter)
+{
+        STRH_INSTRUMENT(split, string.length());
+        std::vector<std::string> ret;
+        ret.reserve(std::count(string.begin(), string.end(), delimiter) + 1);
+        size_t start = 0;
+        size_t end;
+        while ((end = string.find(delimiter, start)) != std::string_view::npos)
+        {
+                ret.emplace_back(string.substr(start, end - start));
+                start = end + 1;
+        }
+
+        if (!string.substr(start).empty())
+                ret.emplace_back(string.substr(start));
+
+        return ret;
+}
+
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::split'.
+ *
+ * @return the substrings of 'string', or 'errc::empty_delimiter' if 'delimiter' is empty.
+ *
+ * @note Allocation failures still throw, as in 'strh::split'.
+ */
+constexpr std::expected<std::vector<std::string>, errc> split(std::string_view string,
+                                                              std::string_view delimiter)
+{
+        STRH_INSTRUMENT(split, string.length());
+        if (delimiter.empty())
+                return std::unexpected(errc::empty_delimiter);
+
+        std::vector<std::string> ret;
+        size_t start = 0;
+        size_t end;
+        while ((end = string.find(delimiter, start)) != std::string::npos)
+        {
+                ret.emplace_back(string.substr(start, end - start));
+                start = end + delimiter.length();
+        }
+
+        if (!string.substr(start).empty())
+                ret.emplace_back(string.substr(start));
+
+        return ret;
+}
+}
+
+/**
+ * Splits 'string' into substrings separated by 'delimiter'.
+ *
+ * @param string the string to split.
+ * @param delimiter the string to split 'string' by.
+ *
+ * @return a vector of the substrings of 'string'.
+ *
+ * @note Reads 'string' once; the vector grows as substrings are found.
+ */
+constexpr std::vector<std::string> split(std::string_view string, std::string_view delimiter)
+{
+        return priv_helpers::value_or_throw(nx::split(string, delimiter));
+}
+
+/**
+ * Splits 'string' into substrings separated by '\n'.
+ *
+ * @param string the string to split.
+ *
+ * @return a vector of the substrings of 'string'.
+ */
+constexpr std::vector<std::string> split_lines(std::string_view string)
+{
+        STRH_INSTRUMENT(split_lines, string.length());
+        return split(string, '\n');
+}
+
+/**
+ * Removes whitespaces at the beginning and end of 'string'.
+ *
+ * @param string the string to remove white spaces of.
+ *
+ * @return 'string' with no whitespaces at the beginning nor end.
+ *
+ * @note whitespaces are ' ', '\t'. '\n'.
+ * @note whitespaces will be removed at the beginning and end until a non-whitespace character is
+ * met.
+ * @note Works in place; does not allocate when 'string' is an rvalue.
+ */
+constexpr std::string strip(std::string string)
+{
+        STRH_INSTRUMENT(strip, string.length());
+        size_t front_whitespaces_end_idx = string.find_first_not_of(" \t\n");
+        if (front_whitespaces_end_idx == std::string::npos)
+        {
+                string.clear();
+        }
+        else
+        {
+                size_t end_whitespaces_start_idx = string.find_last_not_of(" \t\n");
+                string.erase(end_whitespaces_start_idx + 1);
+                string.erase(0, front_whitespaces_end_idx);
+        }
+
+        // GCC 12 cannot move a short std::string parameter in a constant expression.
+        if (std::is_constant_evaluated())
+                return std::string(string);
+        return string;
+}
+
+/**
+ * Swaps the cases of each of character in 'string'
+ *
+ * Lowercase characters are switched to their uppercase counterpart and uppercase characters are
+ * switched to their lowercase counterpart.
+ *
+ * @param string the string to swap the cases of.
+ *
+ * @return 'string' with swapped characters.
+ *
+ * @note Works in place; does not allocate when 'string' is an rvalue.
+ */
+inline std::string swap_cases(std::string string)
+{
+        STRH_INSTRUMENT(swap_cases, string.length());
+        for (char &ch: string)
+        {
+                if (isupper(ch))
+                        ch = static_cast<char>(tolower(ch));
+                else if (islower(ch))
+                        ch = static_cast<char>(toupper(ch));
+        }
+        return string;
+}
+
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::find_first'.
+ *
+ * @return the index of the first occurrence of 'key' in 'string' or '-1', or 'errc::empty_key' if
+ * 'key' is empty.
+ */
+constexpr std::expected<int, errc> find_first(std::string_view string, std::string_view key) noexcept
+{
+        STRH_INSTRUMENT(find_first, string.length());
+        if (key.empty())
+                return std::unexpected(errc::empty_key);
+
+        size_t found_idx = string.find(key);
+        return found_idx <= string.length() ? static_cast<int>(found_idx) : -1;
+}
+}
+
+/**
+ * Finds the index of the first occurrence of 'key' in 'string'.
+ *
+ * @param string the string to search.
+ * @param key the string to search for in 'string'.
+ *
+ * @return the index of the first occurrence of 'key' in 'string'. If 'key' is not in 'string',
+ * will return '-1'.
+ *
+ * @throw std::invalid_argument Thrown if 'key' is empty.
+ */
+constexpr int find_first(std::string_view string, std::string_view key)
+{
+        return priv_helpers::value_or_throw(nx::find_first(string, key));
+}
+
+/**
+ * Finds the index of the first occurrence of 'key' in 'string'.
+ *
+ * @param string the string to search.
+ * @param key the character to search for in 'string'.
+ *
+ * @return the index of the first occurrence of 'key' in 'string'. If 'key' is not in 'string',
+ * will return '-1'.
+ */
+constexpr int find_first(std::string_view string, char key)
+{
+        return strh::find_first(string, std::string_view(&key, 1));
+}
+
+namespace priv_helpers
+{
+
+/**
+ * Finds the last occurrence of 'key' in 'string' starting at or before 'pos' with a backward
+ * Horspool search: each window is compared, then the search skips left by how far the character
+ * at the start of the window is from the front of 'key'.
+ *
+ * @return the index of the occurrence, or 'std::string_view::npos' if there is none.
+ */
+inline size_t find_prev_horspool(std::string_view string, std::string_view key, size_t pos)
+{
+        size_t length = key.length();
+        size_t shift[256];
+        std::fill(shift, shift + 256, length);
+        for (size_t i = length - 1; i > 0; i--)
+                shift[static_cast<unsigned char>(key[i])] = i;
+
+        for (;;)
+        {
+                if (std::memcmp(string.data() + pos, key.data(), length) == 0)
+                        return pos;
+                size_t skip = shift[static_cast<unsigned char>(string[pos])];
+                if (skip > pos)
+                        return std::string_view::npos;
+                pos -= skip;
+        }
+}
+
+/**
+ * Finds the last occurrence of 'key' in 'string' starting at or before 'pos', scanning backward.
+ *
+ * With SSE2, candidates are filtered 16 positions at a time on the first and last characters of
+ * 'key', from the end of 'string', and confirmed with 'memcmp'. Without it, keys of 8 or more
+ * characters use 'find_prev_horspool'.
+ *
+ * @return the index of the occurrence, or 'std::string_view::npos' if there is none.
+ */
+inline size_t find_prev(std::string_view string, std::string_view key, size_t pos)
+{
+        if (key.length() > string.length())
+                return std::string_view::npos;
+
+        pos = std::min(pos, string.length() - key.length());
+        const char *data = string.data();
+        size_t length = key.length();
+
+        // The number of candidate positions left, all before 'remaining'.
+        size_t remaining = pos + 1;
+#if defined(__SSE2__)
+        const __m128i first = _mm_set1_epi8(key[0]);
+        const __m128i last = _mm_set1_epi8(key[length - 1]);
+        for (; remaining >= 16; remaining -= 16)
+        {
+                const char *block = data + remaining - 16;
+                __m128i matches = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(block)), first);
+                if (length > 1)
+                        matches = _mm_and_si128(matches, _mm_cmpeq_epi8(
+                                _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + length - 1)), last));
+                for (unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(matches)); mask != 0;
+                     mask &= ~(1u << (31 - std::countl_zero(mask))))
+                {
+                        size_t idx = remaining - 16 + static_cast<size_t>(31 - std::countl_zero(mask));
+                        if (length <= 2 || std::memcmp(data + idx + 1, key.data() + 1, length - 2) == 0)
+                                return idx;
+                }
+        }
+#else
+        // The vector filter beats the skips at every key length, but a byte at a time they win
+        // from 8 characters on.
+        if (length >= 8)
+                return find_prev_horspool(string, key, pos);
+#endif
+        while (remaining-- > 0)
+        {
+                if (data[remaining] == key[0] && std::memcmp(data + remaining, key.data(), length) == 0)
+                        return remaining;
+        }
+        return std::string_view::npos;
+}
+}
+
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::find_last'.
+ *
+ * @return the index of the last occurrence of 'key' in 'string' or '-1', or 'errc::empty_key' if
+ * 'key' is empty.
+ */
+constexpr std::expected<int, errc> find_last(std::string_view string, std::string_view key) noexcept
+{
+        STRH_INSTRUMENT(find_last, string.length());
+        if (key.empty())
+                return std::unexpected(errc::empty_key);
+
+        size_t found_idx = std::is_constant_evaluated() ? string.rfind(key)
+                                                        : priv_helpers::find_prev(string, key, string.length());
+        return found_idx != std::string::npos ? static_cast<int>(found_idx) : -1;
+}
+}
+
+/**
+ * Finds the index of the last occurrence of 'key' in 'string'.
+ *
+ * @param string the string to search.
+ * @param key the string to search for in 'string'.
+ *
+ * @return the index of the last occurrence of 'key' in 'string'. If 'key' is not in 'string',
+ * will return -1.
+ *
+ * @throw std::invalid_argument Thrown if 'key' is empty.
+ */
+constexpr int find_last(std::string_view string, std::string_view key)
+{
+        return priv_helpers::value_or_throw(nx::find_last(string, key));
+}
+
+/**
+ * Finds the index of the last occurrence of 'key' in 'string'.
+ *
+ * @param string the string to search.
+ * @param key the character to search for in 'string'.
+ *
+ * @return the index of the last occurrence of 'key' in 'string'. If 'key' is not in 'string',
+ * will return -1.
+ */
+constexpr int find_last(std::string_view string, char key)
+{
+        return find_last(string, std::string_view(&key, 1));
+}
+
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::find_last_n'.
+ *
+ * @return the indexes of the last 'amount' occurrences of 'key' in 'string', or 'errc::empty_key'
+ * if 'key' is empty.
+ *
+ * @note Allocation failures still throw, as in 'strh::find_last_n'.
+ */
+inline std::expected<std::vector<size_t>, errc> find_last_n(std::string_view string, std::string_view key,
+                                                            size_t amount)
+{
+        STRH_INSTRUMENT(find_last_n, string.length());
+        if (key.empty())
+                return std::unexpected(errc::empty_key);
+
+        std::vector<size_t> ret;
+        for (size_t pos = priv_helpers::find_prev(string, key, string.length());
+             pos != std::string_view::npos && ret.size() < amount;
+             pos = pos == 0 ? std::string_view::npos : priv_helpers::find_prev(string, key, pos - 1))
+                ret.push_back(pos);
+        std::reverse(ret.begin(), ret.end());
+        return ret;
+}
+}
+
+/**
+ * Finds the indexes of the last 'amount' occurrences of 'key' in 'string'.
+ *
+ * Scans backward from the end of 'string' and stops after 'amount' occurrences, so the front of a
+ * long 'string' is never read when its last occurrences are near the end.
+ *
+ * @param string the string to search.
+ * @param key the string to search for in 'string'.
+ * @param amount the most occurrences to find.
+ *
+ * @return a vector of the indexes of the last 'amount' occurrences of 'key' in 'string', in
+ * ascending order: the last 'amount' indexes 'find' returns.
+ *
+ * @throw std::invalid_argument Thrown if 'key' is empty.
+ */
+inline std::vector<size_t> find_last_n(std::string_view string, std::string_view key, size_t amount)
+{
+        return priv_helpers::value_or_throw(nx::find_last_n(string, key, amount));
+}
+
+/**
+ * Finds the indexes of the last 'amount' occurrences of 'key' in 'string'.
+ *
+ * @param string the string to search.
+ * @param key the character to search for in 'string'.
+ * @param amount the most occurrences to find.
+ *
+ * @return a vector of the indexes of the last 'amount' occurrences of 'key' in 'string', in
+ * ascending order.
+ */
+inline std::vector<size_t> find_last_n(std::string_view string, char key, size_t amount)
+{
+        return find_last_n(string, std::string_view(&key, 1), amount);
+}
+
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::find'.
+ *
+ * @return the indexes 'key' occurs in 'string', or 'errc::empty_key' if 'key' is empty.
+ *
+ * @note Allocation failures still throw, as in 'strh::find'.
+ */
+constexpr std::expected<std::vector<size_t>, errc> find(std::string_view string, std::string_view key)
+{
+        STRH_INSTRUMENT(find, string.length());
+        if (key.empty())
+                return std::unexpected(errc::empty_key);
+
+        std::vector<size_t> ret;
+        size_t pos = string.find(key);
+        while (pos != std::string::npos)
+        {
+                ret.push_back(pos);
+                pos = string.find(key, pos + 1);
+        }
+
+        return ret;
+}
+}
+
+/**
+ * Finds the indexes 'key' occurs in 'string'.
+ *
+ * @param string the string to search.
+ * @param key the string to search for in 'string'.
+ *
+ * @return a vector of the indexes 'key' occurred in 'string'. If 'key' is not in 'string', will
+ * return an empty vector.
+ *
+ * @note Reads 'string' once; the vector grows as occurrences are found.
+ */
+constexpr std::vector<size_t> find(std::string_view string, std::string_view key)
+{
+        return priv_helpers::value_or_throw(nx::find(string, key));
+}
+
+/**
+ * Finds the indexes 'key' occurs in 'string'.
+ *
+ * @param string the string to search.
+ * @param key the character to search for in 'string'.
+ *
+ * @return a vector of the indexes 'key' occurred in 'string'. If 'key' is not in 'string', will
+ * return an empty vector.
+ *
+ * @throw std::invalid_argument Thrown if 'key' is empty.
+ */
+constexpr std::vector<size_t> find(std::string_view string, char key)
+{
+        return strh::find(string, std::string_view(&key, 1));
+}
+
+namespace priv_helpers
+{
+
+/**
+ * Finds the first occurrence of 'key' in 'string' at or after 'pos', ignoring ASCII case.
+ *
+ * Candidates are found by comparing 16 bytes at a time against both cases of the first character
+ * of 'key', then verified 8 bytes at a time with case folded on the fly.
+ *
+ * @return the index of the occurrence, or 'std::string_view::npos' if there is none.
+ */
+inline size_t ifind_next(std::string_view string, std::string_view key, size_t pos)
+{
+        if (key.length() > string.length())
+                return std::string_view::npos;
+
+        size_t last = string.length() - key.length();
+        char first = key[0];
+        char lower = static_cast<char>(fold_word(static_cast<unsigned char>(first)));
+        char upper = lower >= 'a' && lower <= 'z' ? static_cast<char>(lower - 'a' + 'A') : lower;
+        std::string_view rest = key.substr(1);
+
+#if defined(__SSE2__)
+        __m128i lower_block = _mm_set1_epi8(lower);
+        __m128i upper_block = _mm_set1_epi8(upper);
+        for (; pos + 16 <= last + 1; pos += 16)
+        {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(string.data() + pos));
+                __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(block, lower_block),
+                                               _mm_cmpeq_epi8(block, upper_block));
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(matches));
+                while (mask != 0)
+                {
+                        size_t idx = pos + static_cast<size_t>(std::countr_zero(mask));
+                        if (equals_ignore_case(string.substr(idx + 1, rest.length()), rest))
+                                return idx;
+                        mask &= mask - 1;
+                }
+        }
+#endif
+
+        for (; pos <= last; pos++)
+        {
+                char ch = string[pos];
+                if ((ch == lower || ch == upper)
+                    && equals_ignore_case(string.substr(pos + 1, rest.length()), rest))
+                        return pos;
+        }
+        return std::string_view::npos;
+}
+}
+
+namespace nx
+{
 
 /**
- * Checks if all characters in 'string' are uppercase.
- *
- * @param string the string to check.
+ * Non-throwing 'strh::ifind'.
  *
- * @return 'true' if all characters in 'string' are uppercase, 'false' otherwise or if 'string' is
- * empty.
+ * @return the indexes 'key' occurs in 'string' ignoring ASCII case, or 'errc::empty_key' if 'key' is empty.
  *
- * @throw std::invalid_argument Thrown if 'string' is empty.
+ * @note Allocation failures still throw, as in 'strh::ifind'.
  */
-inline bool all_uppercase(std::string_view string)
+inline std::expected<std::vector<size_t>, errc> ifind(std::string_view string, std::string_view key)
 {
-        if (string.empty())
-                throw std::invalid_argument("string cannot be empty");
+        STRH_INSTRUMENT(ifind, string.length());
+        if (key.empty())
+                return std::unexpected(errc::empty_key);
 
-        for (char ch: string)
+        std::vector<size_t> ret;
+        size_t pos = priv_helpers::ifind_next(string, key, 0);
+        while (pos != std::string_view::npos)
         {
-                if (!isupper(ch))
-                        return false;
+                ret.push_back(pos);
+                pos = priv_helpers::ifind_next(string, key, pos + 1);
         }
 
-        if (string.empty())
-                return false;
-
-        return true;
+        return ret;
+}
 }
-
 
 /**
- * Checks if all characters in 'string' are spaces.
+ * Finds the indexes 'key' occurs in 'string', ignoring ASCII case.
  *
- * @param string the string to check.
+ * @param string the string to search.
+ * @param key the string to search for in 'string'.
  *
- * @return 'true' if all characters in 'string' are spaces, 'false' otherwise or if 'string' is
- * empty.
+ * @return a vector of the indexes 'key' occurred in 'string'. If 'key' is not in 'string', will
+ * return an empty vector.
  *
- * @throw std::invalid_argument Thrown if 'string' is empty.
+ * @throw std::invalid_argument Thrown if 'key' is empty.
  */
-inline bool all_spaces(std::string_view string)
+inline std::vector<size_t> ifind(std::string_view string, std::string_view key)
 {
-        if (string.empty())
-                throw std::invalid_argument("string cannot be empty");
-
-        for (char ch: string)
-        {
-                if (!isspace(ch))
-                        return false;
-        }
-
-        if (string.empty())
-                return false;
-
-        return true;
+        return priv_helpers::value_or_throw(nx::ifind(string, key));
 }
 
 /**
- * Splits 'string' into substrings separated by 'delimiter'.
+ * Finds the indexes 'key' occurs in 'string', ignoring ASCII case.
  *
- * @param string the string to split.
- * @param delimiter the character to split 'string' by.
+ * @param string the string to search.
+ * @param key the character to search for in 'string'.
  *
- * @return a vector of the substrings of 'string'.
+ * @return a vector of the indexes 'key' occurred in 'string'. If 'key' is not in 'string', will
+ * return an empty vector.
  */
-inline std::vector<std::string> split(std::string_view string, char delimiter)
+inline std::vector<size_t> ifind(std::string_view string, char key)
 {
-        std::vector<std::string> ret;
-        std::stringstream ss = std::stringstream(std::string(string));
-        std::string split;
-        while (std::getline(ss, split, delimiter))
-                ret.push_back(split);
-        return ret;
+        return strh::ifind(string, std::string_view(&key, 1));
 }
 
+namespace nx
+{
+
 /**
- * Splits 'string' into substrings separated by 'delimiter'.
- *
- * @param string the string to split.
- * @param delimiter the string to split 'string' by.
+ * Non-throwing 'strh::icount'.
  *
- * @return a vector of the substrings of 'string'.
+ * @return the number of times 'key' is in 'string' ignoring ASCII case, or 'errc::empty_key' if 'key' is empty.
  */
-inline std::vector<std::string> split(std::string_view string, std::string_view delimiter)
+inline std::expected<size_t, errc> icount(std::string_view string, std::string_view key) noexcept
 {
-        if (delimiter.empty())
-                throw std::invalid_argument("delimiter cannot be empty");
+        STRH_INSTRUMENT(icount, string.length());
+        if (key.empty())
+                return std::unexpected(errc::empty_key);
 
-        std::vector<std::string> ret;
-        size_t start = 0;
-        size_t end;
-        while ((end = string.find(delimiter, start)) != std::string::npos)
+        size_t ret = 0;
+        size_t pos = 0;
+        while ((pos = priv_helpers::ifind_next(string, key, pos)) != std::string_view::npos)
         {
-                ret.emplace_back(string.substr(start, end - start));
-                start = end + delimiter.length();
+                ret++;
+                pos += key.length();
         }
-
-        if (!string.substr(start).empty())
-                ret.emplace_back(string.substr(start));
-
         return ret;
 }
+}
 
 /**
- * Splits 'string' into substrings separated by '\n'.
+ * Counts the number of times 'key' is in 'string', ignoring ASCII case.
  *
- * @param string the string to split.
+ * @param string the string to search.
+ * @param key the string to count the occurrences of.
  *
- * @return a vector of the substrings of 'string'.
+ * @return the number of times 'key' is in 'string'.
+ *
+ * @throws std::invalid_argument Thrown if 'key' is empty.
  */
-inline std::vector<std::string> split_lines(std::string_view string)
+inline size_t icount(std::string_view string, std::string_view key)
 {
-        return split(string, '\n');
+        return priv_helpers::value_or_throw(nx::icount(string, key));
 }
 
 /**
- * Removes whitespaces at the beginning and end of 'string'.
- *
- * @param string the string to remove white spaces of.
+ * Counts the number of times 'key' is in 'string', ignoring ASCII case.
  *
- * @return 'string' with no whitespaces at the beginning nor end.
+ * @param string the string to search.
+ * @param key the character to count the occurrences of.
  *
- * @note whitespaces are ' ', '\t'. '\n'.
- * @note whitespaces will be removed at the beginning and end until a non-whitespace character is
- * met.
+ * @return the number of times 'key' is in 'string'.
  */
-inline std::string strip(std::string string)
+inline size_t icount(std::string_view string, char key)
 {
-        size_t front_whitespaces_end_idx = string.find_first_not_of(" \t\n");
-        if (front_whitespaces_end_idx == std::string::npos)
-                front_whitespaces_end_idx = 0;
-
-        size_t end_whitespaces_start_idx = string.find_last_not_of(" \t\n");
-
-        size_t new_string_len = end_whitespaces_start_idx - front_whitespaces_end_idx;
-        string = string.substr(front_whitespaces_end_idx, new_string_len + 1);
-        return string;
+        return strh::icount(string, std::string_view(&key, 1));
 }
 
+namespace nx
+{
+
 /**
- * Swaps the cases of each of character in 'string'
- *
- * Lowercase characters are switched to their uppercase counterpart and uppercase characters are
- * switched to their lowercase counterpart.
- *
- * @param string the string to swap the cases of.
+ * Non-throwing 'strh::iis_in'.
  *
- * @return 'string' with swapped characters.
+ * @return whether 'key' is in 'string' ignoring ASCII case, or 'errc::empty_key' if 'key' is empty.
  */
-inline std::string swap_cases(std::string string)
+inline std::expected<bool, errc> iis_in(std::string_view string, std::string_view key) noexcept
 {
-        for (char &ch: string)
-        {
-                if (isupper(ch))
-                        ch = static_cast<char>(tolower(ch));
-                else if (islower(ch))
-                        ch = static_cast<char>(toupper(ch));
-        }
-        return string;
+        STRH_INSTRUMENT(iis_in, string.length());
+        if (key.empty())
+                return std::unexpected(errc::empty_key);
+
+        return priv_helpers::ifind_next(string, key, 0) != std::string_view::npos;
+}
 }
 
 /**
- * Finds the index of the first occurrence of 'key' in 'string'.
+ * Checks if 'key' is in 'string', ignoring ASCII case.
  *
- * @param string the string to search.
+ * @param string the string to check.
  * @param key the string to search for in 'string'.
  *
- * @return the index of the first occurrence of 'key' in 'string'. If 'key' is not in 'string',
- * will return '-1'.
+ * @return 'true' if 'key' is in 'string', 'false' otherwise.
  *
- * @throw std::invalid_argument Thrown if 'key' is empty.
+ * @throws std::invalid_argument Thrown if 'key' is empty.
  */
-inline int find_first(std::string_view string, std::string_view key)
+inline bool iis_in(std::string_view string, std::string_view key)
 {
-        if (key.empty())
-                throw std::invalid_argument("key cannot be empty");
-
-        size_t found_idx = string.find(key);
-        return found_idx <= string.length() ? static_cast<int>(found_idx) : -1;
+        return priv_helpers::value_or_throw(nx::iis_in(string, key));
 }
 
 /**
- * Finds the index of the first occurrence of 'key' in 'string'.
+ * Checks if 'key' is in 'string', ignoring ASCII case.
  *
- * @param string the string to search.
+ * @param string the string to check.
  * @param key the character to search for in 'string'.
  *
- * @return the index of the first occurrence of 'key' in 'string'. If 'key' is not in 'string',
- * will return '-1'.
+ * @return 'true' if 'key' is in 'string', 'false' otherwise.
  */
-inline int find_first(std::string_view string, char key)
+inline bool iis_in(std::string_view string, char key)
 {
-        return strh::find_first(string, std::string(1, key));
+        return strh::iis_in(string, std::string_view(&key, 1));
 }
 
 /**
- * Finds the index of the last occurrence of 'key' in 'string'.
+ * Checks if 'string' starts with 'prefix', ignoring ASCII case.
  *
- * @param string the string to search.
- * @param key the string to search for in 'string'.
+ * @param string the string to check.
+ * @param prefix the string to search for at the start of the string.
  *
- * @return the index of the last occurrence of 'key' in 'string'. If 'key' is not in 'string',
- * will return -1.
+ * @return 'true' if 'string' starts with 'prefix', 'false' otherwise.
+ */
+inline bool istarts_with(std::string_view string, std::string_view prefix)
+{
+        STRH_INSTRUMENT(istarts_with, string.length());
+        if (string.length() < prefix.length())
+                return false;
+
+        return equals_ignore_case(string.substr(0, prefix.length()), prefix);
+}
+
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::istarts_with'.
  *
- * @throw std::invalid_argument Thrown if 'key' is empty.
+ * @return whether 'string' starts with 'key' ignoring ASCII case, or 'errc::empty_string' if 'string'
+ * is empty.
  */
-inline int find_last(std::string_view string, std::string_view key)
+inline std::expected<bool, errc> istarts_with(std::string_view string, char key) noexcept
 {
-        if (key.empty())
-                throw std::invalid_argument("key cannot be empty");
+        STRH_INSTRUMENT(istarts_with, string.length());
+        if (string.empty())
+                return std::unexpected(errc::empty_string);
 
-        size_t found_idx = string.find_last_of(key);
-        return found_idx != std::string::npos ? static_cast<int>(found_idx) : -1;
+        return equals_ignore_case(string.substr(0, 1), std::string_view(&key, 1));
+}
 }
 
 /**
- * Finds the index of the last occurrence of 'key' in 'string'.
+ * Checks if 'string' starts with 'key', ignoring ASCII case.
  *
- * @param string the string to search.
- * @param key the character to search for in 'string'.
+ * @param string the string to check.
+ * @param key the character to search for at the start of the string.
  *
- * @return the index of the last occurrence of 'key' in 'string'. If 'key' is not in 'string',
- * will return -1.
+ * @return 'true' if 'string' starts with 'key', 'false' otherwise.
+ *
+ * @throw std::invalid_argument Thrown if 'string' is empty.
  */
-inline int find_last(std::string_view string, char key)
+inline bool istarts_with(std::string_view string, char key)
 {
-        return find_last(string, std::string(1, key));
+        return priv_helpers::value_or_throw(nx::istarts_with(string, key));
 }
 
 /**
- * Finds the indexes 'key' occurs in 'string'.
+ * Checks if 'string' ends with 'key', ignoring ASCII case.
  *
- * @param string the string to search.
- * @param key the string to search for in 'string'.
+ * @param string the string to check.
+ * @param key the string to search for at the end of the string.
  *
- * @return a vector of the indexes 'key' occurred in 'string'. If 'key' is not in 'string', will
- * return an empty vector.
+ * @return 'true' if 'string' ends with 'key', 'false' otherwise.
  */
-inline std::vector<size_t> find(std::string_view string, std::string_view key)
+inline bool iends_with(std::string_view string, std::string_view key)
 {
-        if (key.empty())
-                throw std::invalid_argument("key cannot be empty");
+        STRH_INSTRUMENT(iends_with, string.length());
+        if (string.length() < key.length())
+                return false;
 
-        std::vector<size_t> ret;
-        size_t pos = string.find(key);
-        while (pos != std::string::npos)
-        {
-                ret.push_back(pos);
-                pos = string.find(key, pos + 1);
-        }
+        return equals_ignore_case(string.substr(string.length() - key.length()), key);
+}
 
-        return ret;
+namespace nx
+{
+
+/**
+ * Non-throwing 'strh::iends_with'.
+ *
+ * @return whether 'string' ends with 'key' ignoring ASCII case, or 'errc::empty_string' if 'string'
+ * is empty.
+ */
+inline std::expected<bool, errc> iends_with(std::string_view string, char key) noexcept
+{
+        STRH_INSTRUMENT(iends_with, string.length());
+        if (string.empty())
+                return std::unexpected(errc::empty_string);
+
+        return equals_ignore_case(string.substr(string.length() - 1), std::string_view(&key, 1));
+}
 }
 
 /**
- * Finds the indexes 'key' occurs in 'string'.
+ * Checks if 'string' ends with 'key', ignoring ASCII case.
  *
- * @param string the string to search.
- * @param key the character to search for in 'string'.
+ * @param string the string to check.
+ * @param key the character to search for at the end of the string.
  *
- * @return a vector of the indexes 'key' occurred in 'string'. If 'key' is not in 'string', will
- * return an empty vector.
+ * @return 'true' if 'string' ends with 'key', 'false' otherwise.
  *
- * @throw std::invalid_argument Thrown if 'key' is empty.
+ * @throw std::invalid_argument Thrown if 'string' is empty.
+ */
+inline bool iends_with(std::string_view string, char key)
+{
+        return priv_helpers::value_or_throw(nx::iends_with(string, key));
+}
+
+namespace priv_helpers
+{
+
+/**
+ * Replaces every occurrence of a string of 'from_length' characters with 'to' in 'string', where
+ * 'find_next(string, pos)' returns the first occurrence at or after 'pos', or
+ * 'std::string_view::npos'.
  */
-inline std::vector<size_t> find(std::string_view string, char key)
+template<typename F>
+inline std::string replace_all(std::string string, size_t from_length, std::string_view to, F &&find_next)
 {
-        return strh::find(string, std::string(1, key));
+        size_t matches = 0;
+        for (size_t idx = find_next(string, 0); idx != std::string_view::npos;
+             idx = find_next(string, idx + from_length))
+                matches++;
+        if (matches == 0)
+                return string;
+
+        // Replacing with something no longer shifts characters left in place; anything longer is
+        // written once into a buffer of the final size.
+        if (to.length() <= from_length)
+        {
+                size_t read = 0;
+                size_t write = 0;
+                size_t idx;
+                while ((idx = find_next(string, read)) != std::string_view::npos)
+                {
+                        std::memmove(string.data() + write, string.data() + read, idx - read);
+                        write += idx - read;
+                        std::memcpy(string.data() + write, to.data(), to.length());
+                        write += to.length();
+                        read = idx + from_length;
+                }
+                std::memmove(string.data() + write, string.data() + read, string.length() - read);
+                string.resize(write + string.length() - read);
+                return string;
+        }
+
+        builder replaced_string(string.length() + matches * (to.length() - from_length));
+        size_t read = 0;
+        size_t idx;
+        while ((idx = find_next(string, read)) != std::string_view::npos)
+        {
+                replaced_string.append(std::string_view(string).substr(read, idx - read)).append(to);
+                read = idx + from_length;
+        }
+        replaced_string.append(std::string_view(string).substr(read));
+        return replaced_string.str();
+}
 }
 
 /**
@@ -655,24 +1889,17 @@ inline std::vector<size_t> find(std::string_view string, char key)
  * @param to the string to replace 'from'.
  *
  * @return 'string' with all occurrences of 'from' replaced with 'to'.
+ *
+ * @note Works in place when 'to' is not longer than 'from', otherwise allocates once.
  */
 inline std::string replace(std::string string, std::string_view from, std::string_view to)
 {
+        STRH_INSTRUMENT(replace, string.length());
         if (from.empty())
-        {
-                std::string new_string = std::string(to);
-                new_string = strh::multiply(new_string, string.length());
-                string = new_string;
-                return string;
-        }
+                return strh::multiply(to, string.length());
 
-        size_t idx = 0;
-        while ((idx = string.find(from, idx)) != std::string::npos)
-        {
-                string.replace(idx, from.length(), to);
-                idx += to.length();
-        }
-        return string;
+        return priv_helpers::replace_all(std::move(string), from.length(), to,
+                                         [from](std::string_view text, size_t pos) { return text.find(from, pos); });
 }
 
 /**
@@ -686,7 +1913,7 @@ inline std::string replace(std::string string, std::string_view from, std::strin
  */
 inline std::string replace(std::string string, char from, std::string_view to)
 {
-        return strh::replace(std::move(string), std::string(1, from), to);
+        return strh::replace(std::move(string), std::string_view(&from, 1), to);
 }
 
 /**
@@ -700,7 +1927,7 @@ inline std::string replace(std::string string, char from, std::string_view to)
  */
 inline std::string replace(std::string string, std::string_view from, char to)
 {
-        return strh::replace(std::move(string), from, std::string(1, to));
+        return strh::replace(std::move(string), from, std::string_view(&to, 1));
 }
 
 /**
@@ -711,10 +1938,14 @@ inline std::string replace(std::string string, std::string_view from, char to)
  * @param to the character to replace 'from'.
  *
  * @return 'string' with all occurrences of 'from' replaced with 'to'.
+ *
+ * @note Works in place; does not allocate when 'string' is an rvalue.
  */
 inline std::string replace(std::string string, char from, char to)
 {
-        return strh::replace(std::move(string), std::string(1, from), std::string(1, to));
+        STRH_INSTRUMENT(replace, string.length());
+        std::replace(string.begin(), string.end(), from, to);
+        return string;
 }
 
 /**
@@ -723,16 +1954,13 @@ inline std::string replace(std::string string, char from, char to)
  * @param string the string to remove numbers from.
  *
  * @return 'string' with all numbers removed.
+ *
+ * @note Works in place; does not allocate when 'string' is an rvalue.
  */
 inline std::string remove_nums(std::string string)
 {
-        std::string new_string;
-        for (char ch: string)
-        {
-                if (!isdigit(ch))
-                        new_string += ch;
-        }
-        string = new_string;
+        STRH_INSTRUMENT(remove_nums, string.length());
+        std::erase_if(string, [](char ch) { return isdigit(ch); });
         return string;
 }
 
@@ -742,16 +1970,13 @@ inline std::string remove_nums(std::string string)
  * @param string the string to remove numbers from.
  *
  * @return 'string' with all alphabetical (letters) removed.
+ *
+ * @note Works in place; does not allocate when 'string' is an rvalue.
  */
 inline std::string remove_alphabetical(std::string string)
 {
-        std::string new_string;
-        for (char ch: string)
-        {
-                if (!isalpha(ch))
-                        new_string += ch;
-        }
-        string = new_string;
+        STRH_INSTRUMENT(remove_alphabetical, string.length());
+        std::erase_if(string, [](char ch) { return isalpha(ch); });
         return string;
 }
 
@@ -764,6 +1989,7 @@ inline std::string remove_alphabetical(std::string string)
  */
 inline std::vector<std::string> split_alphabetical(std::string_view string)
 {
+        STRH_INSTRUMENT(split_alphabetical, string.length());
         std::vector<std::string> ret;
         std::string temp;
         for (char ch : string)
@@ -803,6 +2029,7 @@ inline std::vector<std::string> split_alphabetical(std::string_view string)
 template<typename... T>
 inline std::string from_parameter_pack(T... params)
 {
+        STRH_INSTRUMENT(from_parameter_pack, 0);
         std::stringstream ss;
 
         size_t idx = 1;
@@ -830,6 +2057,7 @@ inline std::string from_parameter_pack(T... params)
 template<typename T>
 inline std::string from_vector(const std::vector<T>& vector, std::string_view delimiter = ", ")
 {
+        STRH_INSTRUMENT(from_vector, 0);
         std::stringstream ss;
         for (size_t i = 0; i < vector.size(); i++)
         {
@@ -840,8 +2068,47 @@ inline std::string from_vector(const std::vector<T>& vector, std::string_view de
         return ss.str();
 }
 
+/**
+ * Joins 'strings' into one string separated by 'delimiter'.
+ *
+ * @tparam Range a range of elements convertible to 'std::string_view'.
+ *
+ * @param strings the strings to join.
+ * @param delimiter the string separating each of 'strings'. (default ", ")
+ *
+ * @return the joined string.
+ *
+ * @note Allocates at most once.
+ */
+template<typename Range>
+inline std::string join(const Range &strings, std::string_view delimiter = ", ")
+{
+        STRH_INSTRUMENT(join, 0);
+        size_t len = 0;
+        size_t amount = 0;
+        for (const auto &string : strings)
+        {
+                len += std::string_view(string).length();
+                amount++;
+        }
+        if (amount == 0)
+                return {};
+
+        builder joined_string(len + (amount - 1) * delimiter.length());
+        bool first = true;
+        for (const auto &string : strings)
+        {
+                if (!first)
+                        joined_string.append(delimiter);
+                joined_string.append(std::string_view(string));
+                first = false;
+        }
+        return joined_string.str();
+}
+
 inline std::string format(int number)
 {
+    STRH_INSTRUMENT(format, 0);
     std::stringstream ss;
     ss.imbue(std::locale(""));
     ss << std::fixed << number;
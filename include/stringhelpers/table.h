@@ -0,0 +1,228 @@
+/**
+ * Fixed-width table rendering.
+ */
+
+#ifndef STRINGHELPERS_TABLE_H
+#define STRINGHELPERS_TABLE_H
+
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "stringhelpers/config.h"
+#include "stringhelpers/stringhelpers.h"
+
+namespace strh
+{
+
+/**
+ * A single table cell: text, an integer or a floating point number.
+ *
+ * @see table
+ */
+using cell = std::variant<std::string_view, long long, double>;
+
+/**
+ * Describes how a column of a table is laid out.
+ *
+ * @see table
+ */
+struct column
+{
+        /** The width of the column. '0' sizes the column to its widest cell. */
+        size_t width = 0;
+        /** Which side(s) to align cells to. */
+        Alignment alignment = LEFT;
+        /** The character padding cells to 'width'. */
+        char fill = ' ';
+        /** Digits after the decimal point for floating point cells. '-1' uses the shortest form. */
+        int precision = -1;
+};
+
+/**
+ * Renders rows of cells into fixed-width text.
+ *
+ * Cells are padded the same way as 'align', except that every cell is padded to exactly its
+ * column's width: for 'CENTER', an odd remainder goes to the right. Cells wider than a fixed
+ * width are truncated. A whole table is rendered into one preallocated buffer.
+ *
+ * @see align
+ */
+class table
+{
+public:
+        /**
+         * Creates a table.
+         *
+         * @param columns the layout of each column.
+         * @param separator the string written between columns.
+         *
+         * @throws std::invalid_argument Thrown if 'columns' is empty.
+         */
+        explicit table(std::vector<column> columns, std::string_view separator = " ")
+                : columns_(std::move(columns)), separator_(separator)
+        {
+                if (columns_.empty())
+                        STRH_THROW(std::invalid_argument("columns cannot be empty"));
+        }
+
+        /**
+         * @return the layout of each column.
+         */
+        const std::vector<column> &columns() const
+        {
+                return columns_;
+        }
+
+        /**
+         * Renders 'cells' and appends the result to 'out'.
+         *
+         * @param cells the cells of every row, one row after the other.
+         * @param out the string to append the rendered rows to. Each row ends with '\n'.
+         *
+         * @throws std::invalid_argument Thrown if the number of cells is not a multiple of the
+         * number of columns.
+         */
+        void render_to(std::span<const cell> cells, std::string &out) const
+        {
+                if (cells.size() % columns_.size() != 0)
+                        STRH_THROW(std::invalid_argument("cells must fill every column of every row"));
+
+                std::vector<size_t> widths = measure(cells);
+                size_t row_len = separator_.length() * (columns_.size() - 1) + 1;
+                for (size_t width : widths)
+                        row_len += width;
+
+                size_t start = out.length();
+                out.resize(start + row_len * (cells.size() / columns_.size()));
+                char *dst = out.data() + start;
+
+                char scratch[64];
+                std::string spill;
+                for (size_t i = 0; i < cells.size(); i++)
+                {
+                        size_t col = i % columns_.size();
+                        if (col != 0)
+                        {
+                                std::memcpy(dst, separator_.data(), separator_.length());
+                                dst += separator_.length();
+                        }
+
+                        std::string_view text = cell_text(cells[i], columns_[col], scratch, spill);
+                        dst = write_cell(dst, text, columns_[col], widths[col]);
+
+                        if (col == columns_.size() - 1)
+                                *dst++ = '\n';
+                }
+        }
+
+        /**
+         * Renders 'cells'.
+         *
+         * @param cells the cells of every row, one row after the other.
+         *
+         * @return the rendered rows. Each row ends with '\n'.
+         *
+         * @throws std::invalid_argument Thrown if the number of cells is not a multiple of the
+         * number of columns.
+         */
+        std::string render(std::span<const cell> cells) const
+        {
+                std::string out;
+                render_to(cells, out);
+                return out;
+        }
+
+private:
+        /**
+         * Computes the width of each column, measuring the cells of columns without a fixed width.
+         */
+        std::vector<size_t> measure(std::span<const cell> cells) const
+        {
+                std::vector<size_t> widths(columns_.size());
+                bool any_auto = false;
+                for (size_t col = 0; col < columns_.size(); col++)
+                {
+                        widths[col] = columns_[col].width;
+                        any_auto |= columns_[col].width == 0;
+                }
+                if (!any_auto)
+                        return widths;
+
+                char scratch[64];
+                std::string spill;
+                for (size_t i = 0; i < cells.size(); i++)
+                {
+                        size_t col = i % columns_.size();
+                        if (columns_[col].width == 0)
+                        {
+                                std::string_view text = cell_text(cells[i], columns_[col], scratch, spill);
+                                widths[col] = std::max(widths[col], text.length());
+                        }
+                }
+                return widths;
+        }
+
+        /**
+         * Returns the text of 'value', formatting numbers into 'scratch', or into 'spill' for fixed
+         * point numbers too long for it.
+         */
+        static std::string_view cell_text(const cell &value, const column &layout,
+                                          char (&scratch)[64], std::string &spill)
+        {
+                if (const auto *text = std::get_if<std::string_view>(&value))
+                        return *text;
+
+                std::to_chars_result result;
+                if (const auto *integer = std::get_if<long long>(&value))
+                        result = std::to_chars(scratch, scratch + sizeof(scratch), *integer);
+                else if (layout.precision < 0)
+                        result = std::to_chars(scratch, scratch + sizeof(scratch), std::get<double>(value));
+                else
+                        result = std::to_chars(scratch, scratch + sizeof(scratch), std::get<double>(value),
+                                               std::chars_format::fixed, layout.precision);
+                if (result.ec == std::errc())
+                        return {scratch, static_cast<size_t>(result.ptr - scratch)};
+
+                // Only fixed point can overflow 'scratch': a sign, the integer digits of the
+                // largest double, the point and the decimals.
+                size_t max_len = std::numeric_limits<double>::max_exponent10 + 3;
+                spill.resize(max_len + static_cast<size_t>(layout.precision));
+                result = std::to_chars(spill.data(), spill.data() + spill.length(),
+                                       std::get<double>(value), std::chars_format::fixed, layout.precision);
+                return {spill.data(), static_cast<size_t>(result.ptr - spill.data())};
+        }
+
+        /**
+         * Writes 'text' padded to 'width' at 'dst'.
+         *
+         * @return the position after the written cell.
+         */
+        static char *write_cell(char *dst, std::string_view text, const column &layout, size_t width)
+        {
+                text = text.substr(0, width);
+                size_t fill_amount = width - text.length();
+                size_t left = 0;
+                if (layout.alignment == LEFT)
+                        left = fill_amount;
+                else if (layout.alignment == CENTER)
+                        left = fill_amount / 2;
+
+                std::memset(dst, layout.fill, left);
+                std::memcpy(dst + left, text.data(), text.length());
+                std::memset(dst + left + text.length(), layout.fill, fill_amount - left);
+                return dst + width;
+        }
+
+        std::vector<column> columns_;
+        std::string separator_;
+};
+}
+
+#endif //STRINGHELPERS_TABLE_H
@@ -0,0 +1,239 @@
+/**
+ * Sorting and deduplicating tokens held as views.
+ */
+
+#ifndef STRINGHELPERS_TOKENS_H
+#define STRINGHELPERS_TOKENS_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "stringhelpers/hash.h"
+#include "stringhelpers/stringhelpers.h"
+
+namespace strh
+{
+
+/**
+ * Helper functions for the token functions.
+ *
+ * @relatealso strh
+ */
+namespace priv_helpers
+{
+
+/**
+ * A token with the 8 bytes of it at the current sort depth, cached as one integer.
+ */
+struct token_entry
+{
+        uint64_t key;
+        std::string_view token;
+};
+
+/**
+ * Returns the bytes of 'token' from 'depth' on as a big-endian integer, padded with zeros, so
+ * comparing keys compares those bytes like 'memcmp'.
+ */
+inline uint64_t token_key(std::string_view token, size_t depth)
+{
+        if (depth >= token.length())
+                return 0;
+
+        size_t length = std::min<size_t>(token.length() - depth, 8);
+        uint64_t ret = 0;
+        std::memcpy(&ret, token.data() + depth, length);
+        if constexpr (std::endian::native == std::endian::little)
+                ret = std::byteswap(ret);
+        return ret;
+}
+
+inline bool entry_less(const token_entry &lhs, const token_entry &rhs)
+{
+        return lhs.key != rhs.key ? lhs.key < rhs.key : lhs.token < rhs.token;
+}
+
+/**
+ * Sorts the entries between 'begin' and 'end', whose keys are for 'depth' and which all share
+ * their first 'depth' bytes, with a multikey quicksort on the keys.
+ */
+inline void sort_entries(token_entry *begin, token_entry *end, size_t depth)
+{
+        while (end - begin > 16)
+        {
+                uint64_t a = begin->key;
+                uint64_t b = begin[(end - begin) / 2].key;
+                uint64_t c = end[-1].key;
+                uint64_t pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+                // Three-way partition: [begin, lt) below the pivot, [lt, gt) equal and [gt, end) above.
+                token_entry *lt = begin;
+                token_entry *gt = end;
+                for (token_entry *it = begin; it < gt;)
+                {
+                        if (it->key < pivot)
+                                std::swap(*it++, *lt++);
+                        else if (it->key > pivot)
+                                std::swap(*it, *--gt);
+                        else
+                                it++;
+                }
+
+                // Equal keys: tokens ending within these 8 bytes are prefixes of the longer ones,
+                // and of each other, so they go first by length; the longer ones continue 8 bytes on.
+                token_entry *longer = std::partition(lt, gt, [&](const token_entry &entry) {
+                        return entry.token.length() <= depth + 8;
+                });
+                std::sort(lt, longer, [](const token_entry &lhs, const token_entry &rhs) {
+                        return lhs.token.length() < rhs.token.length();
+                });
+                for (token_entry *it = longer; it < gt; it++)
+                        it->key = token_key(it->token, depth + 8);
+                sort_entries(longer, gt, depth + 8);
+
+                // Recurse into the smaller side and loop on the larger to bound the stack.
+                if (lt - begin < end - gt)
+                {
+                        sort_entries(begin, lt, depth);
+                        begin = gt;
+                }
+                else
+                {
+                        sort_entries(gt, end, depth);
+                        end = lt;
+                }
+        }
+        std::sort(begin, end, entry_less);
+}
+
+/**
+ * An open-addressing set of tokens, stored as the positions of their first occurrences.
+ */
+class token_set
+{
+public:
+        explicit token_set(size_t capacity)
+                : slots_(std::bit_ceil(std::max<size_t>(capacity * 2, 16)))
+        {
+        }
+
+        /**
+         * Inserts 'token', found at 'position'.
+         *
+         * @return whether 'token' was not in the set yet.
+         */
+        template<typename Range>
+        bool insert(const Range &tokens, std::string_view token, size_t position)
+        {
+                uint64_t token_hash = strh::hash(token);
+                size_t mask = slots_.size() - 1;
+                for (size_t idx = token_hash & mask;; idx = (idx + 1) & mask)
+                {
+                        slot &current = slots_[idx];
+                        if (current.position == empty)
+                        {
+                                current = {token_hash, position};
+                                return true;
+                        }
+                        if (current.hash == token_hash && std::string_view(tokens[current.position]) == token)
+                                return false;
+                }
+        }
+
+private:
+        static constexpr size_t empty = SIZE_MAX;
+
+        struct slot
+        {
+                uint64_t hash = 0;
+                size_t position = empty;
+        };
+
+        std::vector<slot> slots_;
+};
+}
+
+/**
+ * Sorts 'tokens' in place, in the order of 'std::string_view::compare'.
+ *
+ * A multikey quicksort: tokens are partitioned on 8 bytes at a time, cached as one integer next to
+ * each token, and only tokens that tie on those bytes are looked at further. Most comparisons are
+ * then one integer comparison instead of a 'memcmp' through the pointer of each token.
+ *
+ * @param tokens the tokens to sort. Only the views are moved, never the bytes they point to.
+ *
+ * @note Allocates once.
+ */
+inline void sort_tokens(std::span<std::string_view> tokens)
+{
+        STRH_INSTRUMENT(sort_tokens, 0);
+        std::vector<priv_helpers::token_entry> entries;
+        entries.reserve(tokens.size());
+        for (std::string_view token: tokens)
+                entries.push_back({priv_helpers::token_key(token, 0), token});
+
+        priv_helpers::sort_entries(entries.data(), entries.data() + entries.size(), 0);
+        for (size_t i = 0; i < tokens.size(); i++)
+                tokens[i] = entries[i].token;
+}
+
+/**
+ * Finds the distinct tokens of 'tokens'.
+ *
+ * Tokens are deduplicated with one hash table probe each, without sorting.
+ *
+ * @tparam Range a random access range of strings convertible to 'std::string_view', such as a
+ * 'std::vector<std::string>', a 'std::vector<std::string_view>' or a 'string_column'.
+ *
+ * @param tokens the tokens to deduplicate.
+ *
+ * @return the first occurrence of every distinct token, in the order of 'tokens', as views of the
+ * tokens in 'tokens'.
+ *
+ * @see sort_tokens to get them in sorted order.
+ */
+template<typename Range>
+inline std::vector<std::string_view> unique_tokens(const Range &tokens)
+{
+        STRH_INSTRUMENT(unique_tokens, 0);
+        std::vector<std::string_view> ret;
+        priv_helpers::token_set seen(tokens.size());
+        for (size_t i = 0; i < tokens.size(); i++)
+        {
+                std::string_view token = tokens[i];
+                if (seen.insert(tokens, token, i))
+                        ret.push_back(token);
+        }
+        return ret;
+}
+
+/**
+ * Counts the distinct tokens of 'tokens'.
+ *
+ * @tparam Range a random access range of strings convertible to 'std::string_view'.
+ *
+ * @param tokens the tokens to count.
+ *
+ * @return the number of distinct tokens in 'tokens'.
+ *
+ * @see unique_tokens
+ */
+template<typename Range>
+inline size_t count_distinct(const Range &tokens)
+{
+        STRH_INSTRUMENT(count_distinct, 0);
+        size_t ret = 0;
+        priv_helpers::token_set seen(tokens.size());
+        for (size_t i = 0; i < tokens.size(); i++)
+                ret += seen.insert(tokens, std::string_view(tokens[i]), i);
+        return ret;
+}
+}
+
+#endif //STRINGHELPERS_TOKENS_H
@@ -0,0 +1,279 @@
+/**
+ * UTF-8 validation and measurement.
+ */
+
+#ifndef STRINGHELPERS_UTF8_H
+#define STRINGHELPERS_UTF8_H
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "stringhelpers/stringhelpers.h"
+
+namespace strh
+{
+
+/**
+ * Helper functions for the UTF-8 functions.
+ *
+ * @relatealso strh
+ */
+namespace priv_helpers
+{
+
+/**
+ * Returns the index of the first non-ASCII byte in 'string' at or after 'pos', or the length of
+ * 'string' if there is none. Skips 16 bytes at a time.
+ */
+inline size_t skip_ascii(std::string_view string, size_t pos)
+{
+#if defined(__SSE2__)
+        for (; pos + 16 <= string.length(); pos += 16)
+        {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(string.data() + pos));
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(block));
+                if (mask != 0)
+                        return pos + static_cast<size_t>(std::countr_zero(mask));
+        }
+#else
+        for (; pos + 8 <= string.length(); pos += 8)
+        {
+                uint64_t word;
+                std::memcpy(&word, string.data() + pos, sizeof(word));
+                if ((word & 0x8080808080808080ULL) != 0)
+                        break;
+        }
+#endif
+        while (pos < string.length() && static_cast<unsigned char>(string[pos]) < 0x80)
+                pos++;
+        return pos;
+}
+
+/**
+ * Decodes the UTF-8 sequence starting at 'pos'.
+ *
+ * @param codepoint set to the decoded codepoint.
+ *
+ * @return the length of the sequence, or '0' if it is not valid UTF-8 (truncated, overlong,
+ * a surrogate or above U+10FFFF).
+ */
+inline size_t decode_utf8(std::string_view string, size_t pos, uint32_t &codepoint)
+{
+        auto lead = static_cast<unsigned char>(string[pos]);
+        size_t len;
+        uint32_t min;
+        if (lead < 0x80)
+        {
+                codepoint = lead;
+                return 1;
+        }
+        else if ((lead & 0xe0) == 0xc0)
+        {
+                len = 2;
+                codepoint = lead & 0x1f;
+                min = 0x80;
+        }
+        else if ((lead & 0xf0) == 0xe0)
+        {
+                len = 3;
+                codepoint = lead & 0x0f;
+                min = 0x800;
+        }
+        else if ((lead & 0xf8) == 0xf0)
+        {
+                len = 4;
+                codepoint = lead & 0x07;
+                min = 0x10000;
+        }
+        else
+        {
+                return 0;
+        }
+
+        if (string.length() - pos < len)
+                return 0;
+        for (size_t i = 1; i < len; i++)
+        {
+                auto continuation = static_cast<unsigned char>(string[pos + i]);
+                if ((continuation & 0xc0) != 0x80)
+                        return 0;
+                codepoint = (codepoint << 6) | (continuation & 0x3f);
+        }
+
+        if (codepoint < min || codepoint > 0x10ffff || (codepoint >= 0xd800 && codepoint <= 0xdfff))
+                return 0;
+        return len;
+}
+
+/**
+ * Returns the number of terminal columns 'codepoint' occupies: '0' for combining marks and
+ * zero-width characters, '2' for East Asian wide and fullwidth characters and emoji, '1'
+ * otherwise.
+ */
+inline size_t codepoint_width(uint32_t codepoint)
+{
+        if ((codepoint >= 0x0300 && codepoint <= 0x036f) || (codepoint >= 0x200b && codepoint <= 0x200f)
+            || (codepoint >= 0x20d0 && codepoint <= 0x20ff) || (codepoint >= 0xfe00 && codepoint <= 0xfe0f))
+                return 0;
+
+        if ((codepoint >= 0x1100 && codepoint <= 0x115f) || (codepoint >= 0x2e80 && codepoint <= 0xa4cf
+                                                              && codepoint != 0x303f)
+            || (codepoint >= 0xac00 && codepoint <= 0xd7a3) || (codepoint >= 0xf900 && codepoint <= 0xfaff)
+            || (codepoint >= 0xfe30 && codepoint <= 0xfe4f) || (codepoint >= 0xff00 && codepoint <= 0xff60)
+            || (codepoint >= 0xffe0 && codepoint <= 0xffe6) || (codepoint >= 0x1f300 && codepoint <= 0x1f64f)
+            || (codepoint >= 0x1f900 && codepoint <= 0x1f9ff) || (codepoint >= 0x20000 && codepoint <= 0x3fffd))
+                return 2;
+
+        return 1;
+}
+}
+
+/**
+ * Checks if all characters in 'string' are ASCII.
+ *
+ * Checks 16 bytes at a time and stops at the first non-ASCII byte.
+ *
+ * @param string the string to check.
+ *
+ * @return 'true' if every byte of 'string' is below 0x80 or 'string' is empty, 'false' otherwise.
+ */
+inline bool is_ascii(std::string_view string)
+{
+        return priv_helpers::skip_ascii(string, 0) == string.length();
+}
+
+/**
+ * Checks if 'string' is valid UTF-8.
+ *
+ * Runs of ASCII are skipped 16 bytes at a time; multi-byte sequences are decoded and rejected if
+ * truncated, overlong, surrogates or above U+10FFFF.
+ *
+ * @param string the string to check.
+ *
+ * @return 'true' if 'string' is valid UTF-8, 'false' otherwise.
+ */
+inline bool is_valid_utf8(std::string_view string)
+{
+        size_t pos = 0;
+        while ((pos = priv_helpers::skip_ascii(string, pos)) < string.length())
+        {
+                uint32_t codepoint;
+                size_t len = priv_helpers::decode_utf8(string, pos, codepoint);
+                if (len == 0)
+                        return false;
+                pos += len;
+        }
+        return true;
+}
+
+/**
+ * Counts the codepoints in 'string'.
+ *
+ * Counts every byte that is not a UTF-8 continuation byte, 16 bytes at a time.
+ *
+ * @param string the UTF-8 string to count the codepoints of.
+ *
+ * @return the number of codepoints in 'string'. Invalid UTF-8 gives an unspecified count.
+ */
+inline size_t count_codepoints(std::string_view string)
+{
+        size_t ret = 0;
+        size_t pos = 0;
+#if defined(__SSE2__)
+        // Continuation bytes are 0x80-0xbf, which are -128 to -65 as signed bytes.
+        __m128i last_continuation = _mm_set1_epi8(static_cast<char>(0xbf));
+        for (; pos + 16 <= string.length(); pos += 16)
+        {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(string.data() + pos));
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(block, last_continuation)));
+                ret += static_cast<size_t>(std::popcount(mask));
+        }
+#endif
+        for (; pos < string.length(); pos++)
+        {
+                if ((static_cast<unsigned char>(string[pos]) & 0xc0) != 0x80)
+                        ret++;
+        }
+        return ret;
+}
+
+/**
+ * Measures the number of terminal columns 'string' occupies.
+ *
+ * Wide East Asian characters and emoji count as two columns and combining marks as zero. Bytes
+ * that are not valid UTF-8 count as one column each. Pure ASCII is measured by its length.
+ *
+ * @param string the UTF-8 string to measure.
+ *
+ * @return the display width of 'string'.
+ */
+inline size_t display_width(std::string_view string)
+{
+        size_t ret = 0;
+        size_t pos = 0;
+        while (pos < string.length())
+        {
+                size_t ascii_end = priv_helpers::skip_ascii(string, pos);
+                ret += ascii_end - pos;
+                pos = ascii_end;
+                if (pos == string.length())
+                        break;
+
+                uint32_t codepoint;
+                size_t len = priv_helpers::decode_utf8(string, pos, codepoint);
+                if (len == 0)
+                {
+                        ret++;
+                        pos++;
+                        continue;
+                }
+                ret += priv_helpers::codepoint_width(codepoint);
+                pos += len;
+        }
+        return ret;
+}
+
+/**
+ * Adds characters to 'string' to align 'string' to a target display width.
+ *
+ * Same as 'align', except that the width of 'string' is measured in terminal columns instead of
+ * bytes, so multi-byte and wide characters are padded correctly.
+ *
+ * @param string the UTF-8 string to align.
+ * @param alignment which side(s) to align 'string' to.
+ * @param target_width the display width to set 'string' to.
+ * @param fill the ASCII string to add to 'string' to align it.
+ *
+ * @return aligned 'string'.
+ *
+ * @throws std::invalid_argument Thrown if 'fill' is empty.
+ *
+ * @see align
+ */
+inline std::string align_utf8(std::string_view string, Alignment alignment, size_t target_width,
+                              std::string_view fill)
+{
+        size_t width = display_width(string);
+        size_t target_len = target_width > width ? target_width - width + string.length() : 0;
+        return align(string, alignment, target_len, fill);
+}
+
+/**
+ * Adds characters to 'string' to align 'string' to a target display width.
+ *
+ * @see align_utf8(std::string_view, Alignment, size_t, std::string_view)
+ */
+inline std::string align_utf8(std::string_view string, Alignment alignment, size_t target_width, char fill)
+{
+        return align_utf8(string, alignment, target_width, std::string_view(&fill, 1));
+}
+}
+
+#endif //STRINGHELPERS_UTF8_H
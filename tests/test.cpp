@@ -1,5 +1,121 @@
 #include "gtest/gtest.h"
 #include "stringhelpers/stringhelpers.h"
+#include "stringhelpers/table.h"
+#include "stringhelpers/intern_pool.h"
+#include "stringhelpers/fixed_string.h"
+#include "stringhelpers/hash.h"
+#include "stringhelpers/utf8.h"
+#include "stringhelpers/mapped_file.h"
+#include "stringhelpers/stream.h"
+#include "stringhelpers/padded_string.h"
+#include "stringhelpers/string_column.h"
+#include "stringhelpers/record.h"
+#include "stringhelpers/literal.h"
+#include "stringhelpers/matchers.h"
+#include "stringhelpers/compiled_format.h"
+#include "stringhelpers/fuzzy.h"
+#include "stringhelpers/glob.h"
+#include "stringhelpers/prefix_set.h"
+#include "stringhelpers/tokens.h"
+#include "stringhelpers/line_index.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+static thread_local size_t allocations = 0;
+
+void *operator new(std::size_t size)
+{
+    allocations++;
+    if (void *ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+// Not inlined, so GCC does not pair the inlined free() with a non-inlined operator new.
+[[gnu::noinline]] void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// The nothrow and aligned forms are replaced too, so every allocation is counted and freed by the
+// same allocator that made it.
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    allocations++;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    allocations++;
+    size_t align = static_cast<size_t>(alignment);
+    if (void *ptr = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    allocations++;
+    size_t align = static_cast<size_t>(alignment);
+    return std::aligned_alloc(align, std::max<size_t>((size + align - 1) / align * align, align));
+}
+
+[[gnu::noinline]] void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+class alloc_scope
+{
+public:
+    alloc_scope(size_t expected, const char *statement)
+        : expected_(expected), statement_(statement), before_(allocations)
+    {
+    }
+
+    ~alloc_scope()
+    {
+        EXPECT_EQ(allocations - before_, expected_) << statement_;
+    }
+
+private:
+    size_t expected_;
+    const char *statement_;
+    size_t before_;
+};
+
+#define EXPECT_ALLOCS(expected, statement) \
+    do { alloc_scope alloc_scope_(expected, #statement); statement; } while (0)
+#define EXPECT_NO_ALLOC(statement) EXPECT_ALLOCS(0, statement)
 
 TEST(capitalize, basic)
 {
@@ -24,6 +140,12 @@ TEST(align, target_len)
     ASSERT_EQ(string, "****test");
 }
 
+TEST(align, too_long_throws)
+{
+    ASSERT_THROW(strh::align("x", strh::Alignment::LEFT, SIZE_MAX - 1, "ab"), std::exception);
+    ASSERT_THROW(strh::nx::align("x", strh::Alignment::LEFT, SIZE_MAX - 1, "ab"), std::exception);
+}
+
 TEST(align, fill)
 {
     std::string string = "test";
@@ -94,6 +216,111 @@ TEST(multiply, empty_string)
 }
 
 
+TEST(multiply, large_amount)
+{
+    std::string string = "ab";
+    string = strh::multiply(string, 1000);
+    ASSERT_EQ(string.length(), 2000);
+    ASSERT_EQ(strh::count(string, "ab"), 1000);
+}
+
+TEST(align, shorter_target_len)
+{
+    std::string string = "test";
+    string = strh::align(string, strh::Alignment::LEFT, 2, '*');
+    ASSERT_EQ(string, "test");
+}
+
+TEST(align, string_fill)
+{
+    std::string string = "test";
+    string = strh::align(string, strh::Alignment::RIGHT, 9, "ab");
+    ASSERT_EQ(string, "testabab");
+}
+
+TEST(builder, append)
+{
+    strh::builder builder;
+    builder.append("te").append('s').append("t");
+    ASSERT_EQ(builder.view(), "test");
+}
+
+TEST(builder, append_n)
+{
+    strh::builder builder;
+    builder.append_n('*', 3).append_n('-', 0);
+    ASSERT_EQ(builder.view(), "***");
+}
+
+TEST(builder, append_repeat)
+{
+    strh::builder builder;
+    builder.append("x").append_repeat("abc", 5);
+    ASSERT_EQ(builder.view(), "xabcabcabcabcabc");
+}
+
+TEST(builder, append_self)
+{
+    strh::builder builder;
+    builder.append("ES|NQ|");
+    for (int i = 0; i < 4; i++)
+        builder.append(builder.view());
+    ASSERT_EQ(builder.view(), strh::multiply("ES|NQ|", 16));
+
+    strh::builder repeated;
+    repeated.append("ab");
+    repeated.append_repeat(repeated.view(), 100);
+    ASSERT_EQ(repeated.view(), strh::multiply("ab", 101));
+
+    strh::builder aligned;
+    aligned.append("CL");
+    aligned.append_aligned(aligned.view(), strh::Alignment::CENTER, 200, aligned.view());
+    ASSERT_EQ(aligned.view(), strh::multiply("CL", 100));
+}
+
+TEST(builder, append_repeat_too_long_throws_length_error)
+{
+    strh::builder builder;
+    ASSERT_THROW(builder.append_repeat("abc", SIZE_MAX / 2), std::length_error);
+    ASSERT_THROW(strh::multiply("abc", SIZE_MAX / 2), std::length_error);
+}
+
+TEST(builder, append_aligned)
+{
+    strh::builder builder;
+    builder.append_aligned("test", strh::Alignment::CENTER, 8, "*").append('|');
+    ASSERT_EQ(builder.view(), "**test**|");
+}
+
+TEST(builder, append_aligned_empty_fill_throws_invalid_argument)
+{
+    strh::builder builder;
+    ASSERT_THROW(builder.append_aligned("test", strh::Alignment::LEFT, 8, ""), std::invalid_argument);
+}
+
+TEST(builder, append_number)
+{
+    strh::builder builder;
+    builder.append_number(-42).append(',').append_number(1.5).append(',').append_number(7u);
+    ASSERT_EQ(builder.view(), "-42,1.5,7");
+}
+
+TEST(builder, reserve)
+{
+    strh::builder builder(64);
+    size_t capacity = builder.capacity();
+    builder.append_repeat("ab", 32);
+    ASSERT_EQ(builder.capacity(), capacity);
+}
+
+TEST(builder, str)
+{
+    strh::builder builder;
+    builder.append("test");
+    std::string string = builder.str();
+    ASSERT_EQ(string, "test");
+}
+
 TEST(count, character)
 {
     std::string string = "test";
@@ -604,7 +831,74 @@ TEST(find_last, string)
 {
     std::string string = "test";
     size_t found_idx = strh::find_last(string, "es");
-    ASSERT_EQ(found_idx, 2);
+    ASSERT_EQ(found_idx, 1);
+}
+
+TEST(find_last, substring_not_characters)
+{
+    ASSERT_EQ(strh::find_last("test", "st"), 2);
+    ASSERT_EQ(strh::find_last("test", "se"), -1);
+    ASSERT_EQ(strh::find_last("test", "test"), 0);
+    ASSERT_EQ(strh::find_last("test", "tests"), -1);
+    ASSERT_EQ(strh::find_last("aaaa", "aa"), 2);
+    static_assert(strh::find_last("ES|NQ|ES", "ES") == 6);
+}
+
+TEST(find_last, random)
+{
+    std::mt19937 rng(3);
+    for (size_t key_length: {1, 2, 3, 7, 15, 16, 17, 40})
+    {
+        for (int trial = 0; trial < 50; trial++)
+        {
+            std::string string;
+            for (size_t i = 0, length = rng() % 300; i < length; i++)
+                string += static_cast<char>('a' + rng() % 2);
+            std::string key;
+            for (size_t i = 0; i < key_length; i++)
+                key += static_cast<char>('a' + rng() % 2);
+            size_t expected = string.rfind(key);
+            ASSERT_EQ(strh::find_last(string, key), expected == std::string::npos ? -1 : static_cast<int>(expected));
+        }
+    }
+}
+
+TEST(find_last_n, basic)
+{
+    std::string_view string = "35=D|55=ES|55=NQ|55=CL|";
+    ASSERT_EQ(strh::find_last_n(string, "55=", 2), (std::vector<size_t>{11, 17}));
+    ASSERT_EQ(strh::find_last_n(string, "55=", 10), (std::vector<size_t>{5, 11, 17}));
+    ASSERT_EQ(strh::find_last_n(string, '|', 1), (std::vector<size_t>{22}));
+    ASSERT_TRUE(strh::find_last_n(string, "55=", 0).empty());
+    ASSERT_TRUE(strh::find_last_n(string, "44=", 3).empty());
+    ASSERT_EQ(strh::find_last_n("aaaa", "aa", 5), strh::find("aaaa", "aa"));
+    ASSERT_THROW(strh::find_last_n(string, "", 1), std::invalid_argument);
+}
+
+// Only builds without SSE2 search with it, so it is checked directly here.
+TEST(find_last, horspool)
+{
+    std::mt19937 rng(46);
+    for (int trial = 0; trial < 2000; trial++)
+    {
+        std::string string;
+        for (size_t i = 0, length = 8 + rng() % 200; i < length; i++)
+            string += static_cast<char>('a' + rng() % 3);
+        size_t key_length = 8 + rng() % std::min<size_t>(string.length() - 7, 16);
+        std::string key;
+        if (rng() % 2 == 0)
+        {
+            key = string.substr(rng() % (string.length() - key_length + 1), key_length);
+        }
+        else
+        {
+            for (size_t i = 0; i < key_length; i++)
+                key += static_cast<char>('a' + rng() % 3);
+        }
+        size_t pos = rng() % (string.length() - key.length() + 1);
+        ASSERT_EQ(strh::priv_helpers::find_prev_horspool(string, key, pos), std::string_view(string).rfind(key, pos))
+            << string << " " << key << " " << pos;
+    }
 }
 
 TEST(find_last, not_in)
@@ -695,6 +989,80 @@ TEST(find, empty_key_throw_invalid_argument)
     ASSERT_THROW(strh::find(string, ""), std::invalid_argument);
 }
 
+TEST(ifind, string)
+{
+    std::string string = "es|ES|eS|xx";
+    std::vector<size_t> found = strh::ifind(string, "Es");
+    ASSERT_EQ(found, (std::vector<size_t>{0, 3, 6}));
+}
+
+TEST(ifind, character)
+{
+    std::string string = "aAbA";
+    std::vector<size_t> found = strh::ifind(string, 'a');
+    ASSERT_EQ(found, (std::vector<size_t>{0, 1, 3}));
+}
+
+TEST(ifind, long_string)
+{
+    std::string string = strh::multiply("x", 100) + "NyMeX" + strh::multiply("y", 40) + "nymex";
+    std::vector<size_t> found = strh::ifind(string, "NYMEX");
+    ASSERT_EQ(found, (std::vector<size_t>{100, 145}));
+}
+
+TEST(ifind, not_letters)
+{
+    std::string string = "@`[{";
+    ASSERT_EQ(strh::ifind(string, '`'), (std::vector<size_t>{1}));
+    ASSERT_EQ(strh::ifind(string, '{'), (std::vector<size_t>{3}));
+}
+
+TEST(ifind, empty_key_throw_invalid_argument)
+{
+    std::string string = "test";
+    ASSERT_THROW(strh::ifind(string, ""), std::invalid_argument);
+}
+
+TEST(icount, string)
+{
+    std::string string = "TeStTEST";
+    ASSERT_EQ(strh::icount(string, "test"), 2);
+    ASSERT_EQ(strh::icount(string, 't'), 4);
+    ASSERT_EQ(strh::icount(string, "x"), 0);
+}
+
+TEST(icount, empty_key_throws_invalid_argument)
+{
+    std::string string;
+    ASSERT_THROW(strh::icount(string, ""), std::invalid_argument);
+}
+
+TEST(iis_in, basic)
+{
+    std::string string = "ESZ4.cme";
+    ASSERT_TRUE(strh::iis_in(string, "CME"));
+    ASSERT_TRUE(strh::iis_in(string, 'z'));
+    ASSERT_FALSE(strh::iis_in(string, "cbot"));
+}
+
+TEST(istarts_with, basic)
+{
+    std::string string = "Nyse:IBM";
+    ASSERT_TRUE(strh::istarts_with(string, "NYSE"));
+    ASSERT_TRUE(strh::istarts_with(string, 'n'));
+    ASSERT_FALSE(strh::istarts_with(string, "NYSE:IBM:X"));
+    ASSERT_THROW(strh::istarts_with("", 'n'), std::invalid_argument);
+}
+
+TEST(iends_with, basic)
+{
+    std::string string = "IBM.Nyse";
+    ASSERT_TRUE(strh::iends_with(string, "NYSE"));
+    ASSERT_TRUE(strh::iends_with(string, 'E'));
+    ASSERT_FALSE(strh::iends_with(string, "X.IBM.NYSE"));
+    ASSERT_THROW(strh::iends_with("", 'e'), std::invalid_argument);
+}
+
 TEST(replace, character_character)
 {
     std::string string = "test";
@@ -890,3 +1258,1391 @@ int main(int argc, char **argv)
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
+
+TEST(table, fixed_width)
+{
+    strh::table table({{4, strh::Alignment::RIGHT}, {6, strh::Alignment::LEFT, '.'}}, "|");
+    std::vector<strh::cell> cells = {"ES", 12LL, "NQ", -3LL};
+    ASSERT_EQ(table.render(cells), "ES  |....12\nNQ  |....-3\n");
+}
+
+TEST(table, auto_width)
+{
+    strh::table table({{0, strh::Alignment::RIGHT}, {0, strh::Alignment::CENTER, '*'}});
+    std::vector<strh::cell> cells = {"ESZ4", "a", "NQ", "bcd"};
+    ASSERT_EQ(table.render(cells), "ESZ4 *a*\nNQ   bcd\n");
+}
+
+TEST(table, precision)
+{
+    strh::table table({{6, strh::Alignment::LEFT, ' ', 2}});
+    std::vector<strh::cell> cells = {1.5, 100.125};
+    ASSERT_EQ(table.render(cells), "  1.50\n100.12\n");
+
+    strh::table wide({{0, strh::Alignment::LEFT, ' ', 2}});
+    std::vector<strh::cell> huge = {1e300, -std::numeric_limits<double>::max()};
+    std::string rendered = wide.render(huge);
+    ASSERT_EQ(rendered.length(), 2 * (1 + 309 + 3 + 1));
+    ASSERT_EQ(rendered.substr(0, 11), std::string(9, ' ') + "10");
+    ASSERT_EQ(rendered.substr(314, 18), "-17976931348623157");
+    ASSERT_EQ(rendered.substr(rendered.length() - 4), ".00\n");
+}
+
+TEST(table, truncates_fixed_width)
+{
+    strh::table table({{3, strh::Alignment::RIGHT}});
+    std::vector<strh::cell> cells = {"ABCDE"};
+    ASSERT_EQ(table.render(cells), "ABC\n");
+}
+
+TEST(table, render_to_appends)
+{
+    strh::table table({strh::column{2}});
+    std::vector<strh::cell> cells = {"a"};
+    std::string out = "x";
+    table.render_to(cells, out);
+    ASSERT_EQ(out, "x a\n");
+}
+
+TEST(table, partial_row_throws_invalid_argument)
+{
+    strh::table table({strh::column{2}, strh::column{2}});
+    std::vector<strh::cell> cells = {"a"};
+    ASSERT_THROW(table.render(cells), std::invalid_argument);
+}
+
+TEST(table, empty_columns_throws_invalid_argument)
+{
+    ASSERT_THROW(strh::table({}), std::invalid_argument);
+}
+
+TEST(intern_pool, dense_ids)
+{
+    strh::intern_pool pool;
+    ASSERT_EQ(pool.intern("ES"), 0);
+    ASSERT_EQ(pool.intern("NQ"), 1);
+    ASSERT_EQ(pool.intern("ES"), 0);
+    ASSERT_EQ(pool.size(), 2);
+}
+
+TEST(intern_pool, view)
+{
+    strh::intern_pool pool;
+    std::string string = "CME";
+    strh::intern_pool::id_type id = pool.intern(string);
+    string = "XXX";
+    ASSERT_EQ(pool.view(id), "CME");
+}
+
+TEST(intern_pool, find)
+{
+    strh::intern_pool pool;
+    pool.intern("ES");
+    ASSERT_EQ(pool.find("ES"), 0);
+    ASSERT_EQ(pool.find("NQ"), strh::intern_pool::npos);
+}
+
+TEST(intern_pool, empty_string)
+{
+    strh::intern_pool pool;
+    strh::intern_pool::id_type id = pool.intern("");
+    ASSERT_EQ(pool.view(id), "");
+    ASSERT_EQ(pool.intern(""), id);
+}
+
+TEST(intern_pool, many)
+{
+    strh::intern_pool pool;
+    for (int i = 0; i < 5000; i++)
+        ASSERT_EQ(pool.intern(std::to_string(i)), i);
+    for (int i = 0; i < 5000; i++)
+    {
+        ASSERT_EQ(pool.find(std::to_string(i)), i);
+        ASSERT_EQ(pool.view(i), std::to_string(i));
+    }
+}
+
+TEST(intern_pool, concurrent)
+{
+    strh::intern_pool pool;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+        threads.emplace_back([&pool] {
+            for (int i = 0; i < 2000; i++)
+                pool.intern("sym" + std::to_string(i));
+        });
+    for (std::thread &thread : threads)
+        thread.join();
+
+    ASSERT_EQ(pool.size(), 2000);
+    for (int i = 0; i < 2000; i++)
+        ASSERT_EQ(pool.view(pool.find("sym" + std::to_string(i))), "sym" + std::to_string(i));
+}
+
+TEST(fixed_string, layout)
+{
+    static_assert(sizeof(strh::fixed_string<15>) == 16);
+    static_assert(std::is_trivially_copyable_v<strh::fixed_string<15>>);
+}
+
+TEST(fixed_string, basic)
+{
+    strh::fixed_string<15> string = "ESZ4";
+    ASSERT_EQ(string.length(), 4);
+    ASSERT_EQ(string, "ESZ4");
+    ASSERT_EQ(string.str(), "ESZ4");
+}
+
+TEST(fixed_string, too_long_throws_length_error)
+{
+    ASSERT_THROW(strh::fixed_string<3>("test"), std::length_error);
+}
+
+TEST(fixed_string, append)
+{
+    strh::fixed_string<8> string = "ES";
+    string.append("Z4").push_back('!');
+    ASSERT_EQ(string, "ESZ4!");
+    ASSERT_THROW(string.append("long"), std::length_error);
+}
+
+TEST(fixed_string, compare)
+{
+    strh::fixed_string<15> a = "ES";
+    strh::fixed_string<15> b = "NQ";
+    strh::fixed_string<15> c = "ESX";
+    c.resize(2);
+    ASSERT_TRUE(a == c);
+    ASSERT_FALSE(a == b);
+    ASSERT_TRUE(a < b);
+
+    strh::fixed_string<15> d = "E";
+    ASSERT_THROW(d.at(1) = 'S', std::out_of_range);
+    d.resize(2);
+    d[1] = 'S';
+    ASSERT_TRUE(a == d);
+}
+
+TEST(fixed_string, hash)
+{
+    std::unordered_set<strh::fixed_string<15>> set = {"ES", "NQ", "ES"};
+    ASSERT_EQ(set.size(), 2);
+    ASSERT_TRUE(set.contains("NQ"));
+}
+
+TEST(fixed_string, string_view_functions)
+{
+    strh::fixed_string<15> string = "ES|NQ|CL";
+    ASSERT_EQ(strh::count(string, '|'), 2);
+    ASSERT_TRUE(strh::starts_with(string, "ES"));
+    ASSERT_EQ(strh::find_first(string, "NQ"), 3);
+}
+
+TEST(fixed_string, returns_fixed_string)
+{
+    strh::fixed_string<15> string = "  es1z4 ";
+    strh::fixed_string<15> stripped = strh::strip(string);
+    ASSERT_EQ(stripped, "es1z4");
+    ASSERT_EQ(strh::capitalize(stripped), "Es1z4");
+    ASSERT_EQ(strh::swap_cases(stripped), "ES1Z4");
+    ASSERT_EQ(strh::remove_nums(stripped), "esz");
+    ASSERT_EQ(strh::remove_alphabetical(stripped), "14");
+    ASSERT_EQ(strh::strip(strh::fixed_string<4>("   ")), "");
+}
+
+TEST(hash, deterministic)
+{
+    ASSERT_EQ(strh::hash("ESZ4"), strh::hash(std::string("ESZ4")));
+    ASSERT_NE(strh::hash("ESZ4"), strh::hash("ESH5"));
+    ASSERT_NE(strh::hash("ESZ4"), strh::hash("ESZ4", 1));
+}
+
+TEST(hash, all_lengths)
+{
+    std::string string = strh::multiply("abcdefghij", 10);
+    std::unordered_set<uint64_t> hashes;
+    for (size_t len = 0; len <= string.length(); len++)
+        hashes.insert(strh::hash(std::string_view(string).substr(0, len)));
+    ASSERT_EQ(hashes.size(), string.length() + 1);
+}
+
+TEST(hash_ignore_case, all_lengths)
+{
+    std::string lower = strh::multiply("abcdefghij", 10);
+    std::string upper = strh::swap_cases(lower);
+    for (size_t len = 0; len <= lower.length(); len++)
+        ASSERT_EQ(strh::hash_ignore_case(std::string_view(lower).substr(0, len)),
+                  strh::hash_ignore_case(std::string_view(upper).substr(0, len)));
+}
+
+TEST(hash_ignore_case, non_letters)
+{
+    ASSERT_NE(strh::hash_ignore_case("@"), strh::hash_ignore_case("`"));
+    ASSERT_NE(strh::hash_ignore_case("[ES]"), strh::hash_ignore_case("{ES}"));
+}
+
+TEST(equals_ignore_case, basic)
+{
+    ASSERT_TRUE(strh::equals_ignore_case("Es.Cme-Globex", "ES.CME-GLOBEX"));
+    ASSERT_FALSE(strh::equals_ignore_case("ES.CME-GLOBEX", "ES.CME_GLOBEX"));
+    ASSERT_FALSE(strh::equals_ignore_case("ES", "ESZ"));
+    ASSERT_FALSE(strh::equals_ignore_case("@", "`"));
+}
+
+TEST(hasher, heterogeneous_lookup)
+{
+    std::unordered_map<std::string, int, strh::hasher, std::equal_to<>> map = {{"ES", 1}};
+    std::string_view key = "ES";
+    ASSERT_EQ(map.find(key)->second, 1);
+}
+
+TEST(ihash, heterogeneous_lookup)
+{
+    std::unordered_map<std::string, int, strh::ihash, strh::iequal> map = {{"Nyse", 1}};
+    std::string_view key = "NYSE";
+    ASSERT_EQ(map.find(key)->second, 1);
+    ASSERT_EQ(map.count("nyse"), 1);
+    ASSERT_EQ(map.count("nyse2"), 0);
+}
+
+TEST(is_ascii, basic)
+{
+    ASSERT_TRUE(strh::is_ascii(""));
+    ASSERT_TRUE(strh::is_ascii(strh::multiply("ES|NQ|", 20)));
+    ASSERT_FALSE(strh::is_ascii(strh::multiply("ES|NQ|", 20) + "\xc3\xa9"));
+}
+
+TEST(is_valid_utf8, valid)
+{
+    ASSERT_TRUE(strh::is_valid_utf8(""));
+    ASSERT_TRUE(strh::is_valid_utf8("caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80"));
+    ASSERT_TRUE(strh::is_valid_utf8(strh::multiply("abc", 10) + "\xe6\x97\xa5\xe6\x9c\xac"));
+}
+
+TEST(is_valid_utf8, invalid)
+{
+    ASSERT_FALSE(strh::is_valid_utf8("\x80"));
+    ASSERT_FALSE(strh::is_valid_utf8("abc\xc3"));
+    ASSERT_FALSE(strh::is_valid_utf8("\xc0\xaf"));
+    ASSERT_FALSE(strh::is_valid_utf8("\xed\xa0\x80"));
+    ASSERT_FALSE(strh::is_valid_utf8("\xf4\x90\x80\x80"));
+    ASSERT_FALSE(strh::is_valid_utf8(strh::multiply("abc", 10) + "\xff"));
+}
+
+TEST(count_codepoints, basic)
+{
+    ASSERT_EQ(strh::count_codepoints(""), 0);
+    ASSERT_EQ(strh::count_codepoints("test"), 4);
+    ASSERT_EQ(strh::count_codepoints(strh::multiply("caf\xc3\xa9", 10)), 40);
+}
+
+TEST(display_width, basic)
+{
+    ASSERT_EQ(strh::display_width("test"), 4);
+    ASSERT_EQ(strh::display_width("caf\xc3\xa9"), 4);
+    ASSERT_EQ(strh::display_width("\xe6\x97\xa5\xe6\x9c\xac"), 4);
+    ASSERT_EQ(strh::display_width("e\xcc\x81"), 1);
+}
+
+TEST(align_utf8, basic)
+{
+    ASSERT_EQ(strh::align_utf8("caf\xc3\xa9", strh::Alignment::RIGHT, 6, '*'), "caf\xc3\xa9**");
+    ASSERT_EQ(strh::align_utf8("\xe6\x97\xa5", strh::Alignment::LEFT, 4, '*'), "**\xe6\x97\xa5");
+    ASSERT_EQ(strh::align_utf8("test", strh::Alignment::CENTER, 8, '*'), "**test**");
+    ASSERT_EQ(strh::align_utf8("caf\xc3\xa9", strh::Alignment::RIGHT, 2, '*'), "caf\xc3\xa9");
+}
+
+#if STRINGHELPERS_HAS_MAPPED_FILE
+struct temp_file
+{
+    explicit temp_file(std::string_view contents)
+        : path((std::filesystem::temp_directory_path()
+                / ("strh_test_" + std::to_string(::getpid()) + "_" + std::to_string(counter++))).string())
+    {
+        std::ofstream(path, std::ios::binary) << contents;
+    }
+
+    ~temp_file()
+    {
+        std::filesystem::remove(path);
+    }
+
+    static inline int counter = 0;
+    std::string path;
+};
+
+TEST(mapped_file, view)
+{
+    temp_file file("ES|NQ\nCL|GC\n");
+    strh::mapped_file mapped(file.path);
+    ASSERT_EQ(mapped.view(), "ES|NQ\nCL|GC\n");
+    ASSERT_EQ(strh::count(mapped, '|'), 2);
+    ASSERT_EQ(strh::split_lines(mapped), (std::vector<std::string>{"ES|NQ", "CL|GC"}));
+}
+
+TEST(mapped_file, empty_file)
+{
+    temp_file file("");
+    strh::mapped_file mapped(file.path);
+    ASSERT_TRUE(mapped.empty());
+    ASSERT_EQ(mapped.view(), "");
+}
+
+TEST(mapped_file, move)
+{
+    temp_file file("test");
+    strh::mapped_file mapped(file.path);
+    strh::mapped_file moved = std::move(mapped);
+    ASSERT_EQ(moved.view(), "test");
+    ASSERT_TRUE(mapped.empty());
+}
+
+TEST(mapped_file, missing_file_throws_system_error)
+{
+    ASSERT_THROW(strh::mapped_file("/nonexistent/strh_test"), std::system_error);
+}
+
+#endif
+
+TEST(for_each_line, matches_split_lines)
+{
+    for (std::string string : {"", "a", "a\n", "a\n\nb", "\n\na\n", "a\nb"})
+    {
+        std::vector<std::string> lines;
+        strh::for_each_line(string, [&](std::string_view line) { lines.emplace_back(line); });
+        ASSERT_EQ(lines, strh::split_lines(string)) << string;
+    }
+}
+
+#if STRINGHELPERS_HAS_MAPPED_FILE
+TEST(for_each_line_in_file, basic)
+{
+    temp_file file("a\nbb\nccc");
+    std::vector<std::string> lines;
+    strh::for_each_line_in_file(file.path, [&](std::string_view line) { lines.emplace_back(line); });
+    ASSERT_EQ(lines, (std::vector<std::string>{"a", "bb", "ccc"}));
+}
+
+TEST(count_in_file, basic)
+{
+    temp_file file("35=D|35=8|");
+    ASSERT_EQ(strh::count_in_file(file.path, "35="), 2);
+    ASSERT_EQ(strh::find_in_file(file.path, "35="), (std::vector<size_t>{0, 5}));
+}
+#endif
+
+TEST(stream_searcher, straddling)
+{
+    strh::stream_searcher searcher("35=");
+    std::vector<size_t> found;
+    auto on_match = [&](size_t offset) { found.push_back(offset); };
+    searcher.feed("8=FIX|3", on_match);
+    searcher.feed("5", on_match);
+    searcher.feed("=D|35=8|", on_match);
+    ASSERT_EQ(found, (std::vector<size_t>{6, 11}));
+    ASSERT_EQ(searcher.matches(), 2);
+}
+
+TEST(stream_searcher, matches_find)
+{
+    std::string string = strh::multiply("aab|ab|aaab|", 20);
+    std::mt19937 rng(1);
+    for (std::string_view key : {"a", "ab", "aab", "|aa", "b|aaab|a"})
+    {
+        strh::stream_searcher searcher(key);
+        std::vector<size_t> found;
+        for (size_t pos = 0; pos < string.length();)
+        {
+            size_t len = rng() % 5;
+            searcher.feed(std::string_view(string).substr(pos, len), [&](size_t offset) { found.push_back(offset); });
+            pos += len;
+        }
+        ASSERT_EQ(found, strh::find(string, key)) << key;
+    }
+}
+
+TEST(stream_searcher, empty_key_throws_invalid_argument)
+{
+    ASSERT_THROW(strh::stream_searcher(""), std::invalid_argument);
+}
+
+TEST(stream_splitter, straddling)
+{
+    strh::stream_splitter splitter("||");
+    std::vector<std::string> tokens;
+    std::vector<size_t> offsets;
+    auto on_token = [&](std::string_view token, size_t offset) {
+        tokens.emplace_back(token);
+        offsets.push_back(offset);
+    };
+    splitter.feed("ES|", on_token);
+    splitter.feed("|N", on_token);
+    splitter.feed("Q||CL", on_token);
+    splitter.finish(on_token);
+    ASSERT_EQ(tokens, (std::vector<std::string>{"ES", "NQ", "CL"}));
+    ASSERT_EQ(offsets, (std::vector<size_t>{0, 4, 8}));
+}
+
+TEST(stream_splitter, matches_split)
+{
+    std::string string = strh::multiply("aa||b|||c||||d|", 20) + "tail";
+    std::mt19937 rng(2);
+    for (std::string_view delimiter : {"|", "||", "|||", "a||b"})
+    {
+        strh::stream_splitter splitter(delimiter);
+        std::vector<std::string> tokens;
+        auto on_token = [&](std::string_view token, size_t offset) {
+            tokens.emplace_back(token);
+            ASSERT_EQ(string.substr(offset, token.length()), token);
+        };
+        for (size_t pos = 0; pos < string.length();)
+        {
+            size_t len = rng() % 6;
+            splitter.feed(std::string_view(string).substr(pos, len), on_token);
+            pos += len;
+        }
+        splitter.finish(on_token);
+        ASSERT_EQ(tokens, strh::split(string, delimiter)) << delimiter;
+    }
+}
+
+TEST(stream_splitter, character)
+{
+    strh::stream_splitter splitter('\n');
+    std::vector<std::string> lines;
+    auto on_token = [&](std::string_view token, size_t) { lines.emplace_back(token); };
+    splitter.feed("a\nb", on_token);
+    splitter.feed("c\n", on_token);
+    splitter.finish(on_token);
+    ASSERT_EQ(lines, (std::vector<std::string>{"a", "bc"}));
+}
+
+TEST(stream_splitter, empty_delimiter_throws_invalid_argument)
+{
+    ASSERT_THROW(strh::stream_splitter(""), std::invalid_argument);
+}
+
+TEST(allocations, views)
+{
+    std::string string = strh::multiply("ES|NQ|CL|GC|", 10);
+    EXPECT_NO_ALLOC(strh::count(string, '|'));
+    EXPECT_NO_ALLOC(strh::count(string, "NQ"));
+    EXPECT_NO_ALLOC(strh::starts_with(string, "ES"));
+    EXPECT_NO_ALLOC(strh::starts_with(string, 'E'));
+    EXPECT_NO_ALLOC(strh::ends_with(string, "GC|"));
+    EXPECT_NO_ALLOC(strh::ends_with(string, '|'));
+    EXPECT_NO_ALLOC(strh::is_in(string, "CL"));
+    EXPECT_NO_ALLOC(strh::is_in(string, 'C'));
+    EXPECT_NO_ALLOC(strh::all_nums(string));
+    EXPECT_NO_ALLOC(strh::all_alphabetical(string));
+    EXPECT_NO_ALLOC(strh::all_lowercase(string));
+    EXPECT_NO_ALLOC(strh::all_uppercase(string));
+    EXPECT_NO_ALLOC(strh::all_spaces(string));
+    EXPECT_NO_ALLOC(strh::find_first(string, "CL"));
+    EXPECT_NO_ALLOC(strh::find_first(string, 'C'));
+    EXPECT_NO_ALLOC(strh::find_last(string, "CL"));
+    EXPECT_NO_ALLOC(strh::find_last(string, 'C'));
+    EXPECT_NO_ALLOC(strh::icount(string, "nq"));
+    EXPECT_NO_ALLOC(strh::iis_in(string, "cl"));
+    EXPECT_NO_ALLOC(strh::istarts_with(string, "es"));
+    EXPECT_NO_ALLOC(strh::iends_with(string, "gc|"));
+    EXPECT_NO_ALLOC(strh::hash(string));
+    EXPECT_NO_ALLOC(strh::is_valid_utf8(string));
+    EXPECT_NO_ALLOC(strh::count_codepoints(string));
+    EXPECT_NO_ALLOC(strh::histogram(string));
+    EXPECT_NO_ALLOC(strh::find(string, "zz"));
+    EXPECT_NO_ALLOC(strh::ifind(string, "zz"));
+    EXPECT_NO_ALLOC(strh::find_last_n(string, "zz", 3));
+
+    strh::padded_string padded(string);
+    EXPECT_NO_ALLOC(strh::count(padded, '|'));
+    EXPECT_NO_ALLOC(strh::count(padded, "NQ"));
+    EXPECT_NO_ALLOC(strh::strip(padded));
+    EXPECT_NO_ALLOC(strh::all_nums(padded));
+    EXPECT_NO_ALLOC(strh::all_alphabetical(padded));
+    EXPECT_NO_ALLOC(strh::all_lowercase(padded));
+    EXPECT_NO_ALLOC(strh::all_uppercase(padded));
+    EXPECT_NO_ALLOC(strh::all_spaces(padded));
+
+    strh::prefix_set prefixes;
+    prefixes.add("ES");
+    prefixes.add("ES|NQ");
+    EXPECT_NO_ALLOC(prefixes.match(string));
+
+    std::string lines = strh::replace(string, '|', '\n');
+    strh::line_index index(lines);
+    EXPECT_NO_ALLOC(index.line(3));
+    EXPECT_NO_ALLOC(index.line_of(20));
+}
+
+TEST(allocations, in_place)
+{
+    std::string string = strh::multiply("  Es1|nq2  ", 10);
+    EXPECT_NO_ALLOC(string = strh::capitalize(std::move(string)));
+    EXPECT_NO_ALLOC(string = strh::swap_cases(std::move(string)));
+    EXPECT_NO_ALLOC(string = strh::strip(std::move(string)));
+    EXPECT_NO_ALLOC(string = strh::remove_nums(std::move(string)));
+    EXPECT_NO_ALLOC(string = strh::remove_alphabetical(std::move(string)));
+    EXPECT_NO_ALLOC(string = strh::replace(std::move(string), '|', ','));
+    EXPECT_NO_ALLOC(string = strh::replace(std::move(string), ",", ""));
+    EXPECT_NO_ALLOC(string = strh::replace(std::move(string), "not in", "longer than before"));
+}
+
+TEST(allocations, sized_output)
+{
+    std::string string = strh::multiply("ES|NQ|CL|GC|", 10);
+    std::vector<std::string_view> tokens = {"ESZ4.CME", "NQZ4.CME", "CLF5.NYMEX"};
+    std::vector<size_t> found;
+    std::string result;
+    EXPECT_ALLOCS(1, result = strh::multiply("ESZ4.CME.", 4));
+    EXPECT_ALLOCS(1, result = strh::align(string, strh::Alignment::CENTER, 200, "*"));
+    std::string copy = string;
+    EXPECT_ALLOCS(1, result = strh::replace(std::move(copy), "|", "||"));
+    EXPECT_ALLOCS(1, result = strh::join(tokens, " | "));
+    EXPECT_ALLOCS(1, strh::split(string, '|'));
+    std::string lines = strh::replace(string, '|', '\n');
+    EXPECT_ALLOCS(1, strh::split_lines(lines));
+    EXPECT_ALLOCS(1, found = strh::find_last_n(string, "NQ", 1));
+    EXPECT_ALLOCS(1, found = strh::count_any(string, "|EN"));
+    EXPECT_ALLOCS(1, strh::padded_string padded(string));
+}
+
+TEST(join, basic)
+{
+    std::vector<std::string> strings = {"ES", "NQ", "CL"};
+    ASSERT_EQ(strh::join(strings), "ES, NQ, CL");
+    ASSERT_EQ(strh::join(strings, "|"), "ES|NQ|CL");
+    ASSERT_EQ(strh::join(std::vector<std::string>{}), "");
+}
+
+TEST(replace, longer_to)
+{
+    std::string string = "a|b|c";
+    string = strh::replace(string, "|", "<>");
+    ASSERT_EQ(string, "a<>b<>c");
+}
+
+TEST(replace, shorter_to)
+{
+    std::string string = "a<>b<>c<>";
+    string = strh::replace(string, "<>", "|");
+    ASSERT_EQ(string, "a|b|c|");
+}
+
+TEST(ends_with, key_longer)
+{
+    ASSERT_FALSE(strh::ends_with("ES", "ESZ4"));
+}
+
+TEST(nx, values)
+{
+    ASSERT_EQ(strh::nx::count("ES|NQ|ES", "ES"), 2);
+    ASSERT_EQ(strh::nx::align("ES", strh::Alignment::RIGHT, 4, "*"), "ES**");
+    ASSERT_EQ(strh::nx::split("ES|NQ", "|").value(), (std::vector<std::string>{"ES", "NQ"}));
+    ASSERT_EQ(strh::nx::find("ES|NQ|ES", "ES").value(), (std::vector<size_t>{0, 6}));
+    ASSERT_EQ(strh::nx::find_last("ES|NQ|ES", "|"), 5);
+    ASSERT_EQ(strh::nx::icount("es|NQ|ES", "Es"), 2);
+    ASSERT_TRUE(strh::nx::all_nums("123").value());
+    ASSERT_TRUE(strh::nx::istarts_with("es", 'E').value());
+}
+
+TEST(nx, errors)
+{
+    ASSERT_EQ(strh::nx::count("ES", "").error(), strh::errc::empty_key);
+    ASSERT_EQ(strh::nx::is_in("ES", "").error(), strh::errc::empty_key);
+    ASSERT_EQ(strh::nx::ifind("ES", "").error(), strh::errc::empty_key);
+    ASSERT_EQ(strh::nx::ends_with("", 'S').error(), strh::errc::empty_string);
+    ASSERT_EQ(strh::nx::all_spaces("").error(), strh::errc::empty_string);
+    ASSERT_EQ(strh::nx::align("ES", strh::Alignment::LEFT, 4, "").error(), strh::errc::empty_fill);
+    ASSERT_EQ(strh::nx::align("ES", static_cast<strh::Alignment>(7), 4, "*").error(),
+              strh::errc::invalid_alignment);
+    ASSERT_EQ(strh::nx::split("ES", "").error(), strh::errc::empty_delimiter);
+}
+
+TEST(nx, wrapper_messages)
+{
+    try
+    {
+        strh::count("ES", "");
+        FAIL();
+    }
+    catch (const std::invalid_argument &e)
+    {
+        ASSERT_STREQ(e.what(), strh::error_message(strh::errc::empty_key));
+    }
+}
+
+TEST(padded_string, layout)
+{
+    strh::padded_string string("ESZ4.CME");
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(string.data()) % strh::padded_string::alignment, 0);
+    ASSERT_EQ(string.view(), "ESZ4.CME");
+    for (size_t i = 0; i < strh::padded_view::padding; i++)
+        ASSERT_EQ(string.data()[string.length() + i], '\0');
+}
+
+TEST(padded_string, reuse)
+{
+    strh::padded_string string(std::string_view("ESZ4.CME|NQZ4.CME"));
+    const char *data = string.data();
+    string.assign("CLF5");
+    ASSERT_EQ(string.data(), data);
+    ASSERT_EQ(string.view(), "CLF5");
+    ASSERT_EQ(string.data()[4], '\0');
+    string.resize(6);
+    ASSERT_EQ(string.view(), std::string_view("CLF5\0\0", 6));
+}
+
+TEST(padded_string, copy_and_move)
+{
+    strh::padded_string string("ES|NQ");
+    strh::padded_string copy = string;
+    strh::padded_string moved = std::move(string);
+    ASSERT_EQ(copy.view(), "ES|NQ");
+    ASSERT_EQ(moved.view(), "ES|NQ");
+    ASSERT_TRUE(string.empty());
+}
+
+TEST(padded_view, kernels_match)
+{
+    std::mt19937 rng(38);
+    const std::string alphabet = "ab|AB09 \t\n\xc3";
+    for (size_t length = 0; length < 100; length++)
+    {
+        for (int round = 0; round < 20; round++)
+        {
+            std::string string;
+            for (size_t i = 0; i < length; i++)
+                string += alphabet[rng() % (round % 2 ? alphabet.length() : 3)];
+            strh::padded_string padded(string);
+            std::string_view view = string;
+
+            ASSERT_EQ(strh::count(padded, '|'), strh::count(view, '|'));
+            ASSERT_EQ(strh::count(padded, "a|"), strh::count(view, "a|"));
+            ASSERT_EQ(strh::find(padded, 'a'), strh::find(view, 'a'));
+            ASSERT_EQ(strh::find(padded, "aa"), strh::find(view, "aa"));
+            ASSERT_EQ(strh::split(padded, '|'), strh::split(view, '|'));
+            ASSERT_EQ(strh::strip(padded), strh::strip(string));
+            if (length == 0)
+                continue;
+            ASSERT_EQ(strh::all_nums(padded), strh::all_nums(view));
+            ASSERT_EQ(strh::all_alphabetical(padded), strh::all_alphabetical(view));
+            ASSERT_EQ(strh::all_lowercase(padded), strh::all_lowercase(view));
+            ASSERT_EQ(strh::all_uppercase(padded), strh::all_uppercase(view));
+            ASSERT_EQ(strh::all_spaces(padded), strh::all_spaces(view));
+        }
+    }
+}
+
+TEST(padded_view, predicates)
+{
+    ASSERT_TRUE(strh::all_nums(strh::padded_string("0123456789012345678")));
+    ASSERT_TRUE(strh::all_spaces(strh::padded_string(" \t\n\r\v\f")));
+    ASSERT_FALSE(strh::all_uppercase(strh::padded_string("ESZNQZCLFGCGZSIHHGH4")));
+    ASSERT_THROW(strh::all_nums(strh::padded_string()), std::invalid_argument);
+    ASSERT_EQ(strh::nx::count(strh::padded_string("ES"), "").error(), strh::errc::empty_key);
+}
+
+TEST(padded_view, strip)
+{
+    strh::padded_string string("  \t ESZ4.CME  \n ");
+    strh::padded_view stripped = strh::strip(string);
+    ASSERT_EQ(stripped, "ESZ4.CME");
+    ASSERT_EQ(stripped.data(), string.data() + 4);
+    ASSERT_EQ(strh::strip(strh::padded_string(" \t\n ")), "");
+}
+
+TEST(string_column, push_back)
+{
+    strh::string_column column;
+    column.push_back("ESZ4");
+    column.push_back("");
+    column.push_back("NQZ4");
+    ASSERT_EQ(column.size(), 3);
+    ASSERT_EQ(column[0], "ESZ4");
+    ASSERT_EQ(column[1], "");
+    ASSERT_EQ(column.blob(), "ESZ4NQZ4");
+    ASSERT_EQ(std::vector<uint32_t>(column.offsets().begin(), column.offsets().end()),
+              (std::vector<uint32_t>{0, 4, 4, 8}));
+}
+
+TEST(string_column, split)
+{
+    std::string string = "ES|NQ||CL|";
+    strh::string_column column;
+    strh::split(string, '|', column);
+    ASSERT_EQ(std::vector<std::string>(column.begin(), column.end()), strh::split(string, '|'));
+
+    std::string lines = "ESZ4\nNQZ4\n";
+    strh::large_string_column line_column;
+    strh::split_lines(lines, line_column);
+    ASSERT_EQ(std::vector<std::string>(line_column.begin(), line_column.end()), strh::split_lines(lines));
+}
+
+TEST(string_column, ops)
+{
+    strh::string_column column;
+    strh::split(" es z4 |123|| \t|esh5", '|', column);
+    ASSERT_EQ(strh::count(column, 'e'), (std::vector<size_t>{1, 0, 0, 0, 1}));
+    ASSERT_EQ(strh::all_nums(column), (std::vector<bool>{false, true, false, false, false}));
+    ASSERT_EQ(strh::starts_with(column, "es"), (std::vector<bool>{false, false, false, false, true}));
+
+    strh::string_column upper = strh::to_upper(column);
+    ASSERT_EQ(upper[0], " ES Z4 ");
+    ASSERT_EQ(upper[4], "ESH5");
+
+    strh::string_column stripped = strh::strip(column);
+    ASSERT_EQ(std::vector<std::string>(stripped.begin(), stripped.end()),
+              (std::vector<std::string>{"es z4", "123", "", "", "esh5"}));
+}
+
+TEST(string_column, serialize)
+{
+    strh::string_column column;
+    strh::split("ESZ4.CME|NQZ4.CME||CLF5.NYMEX", '|', column);
+    std::stringstream stream;
+    column.write(stream);
+    strh::string_column read = strh::string_column::read(stream);
+    ASSERT_EQ(std::vector<std::string>(read.begin(), read.end()),
+              std::vector<std::string>(column.begin(), column.end()));
+
+    std::stringstream wrong_width(stream.str());
+    ASSERT_THROW(strh::large_string_column::read(wrong_width), std::runtime_error);
+    std::stringstream truncated(stream.str().substr(0, 30));
+    ASSERT_THROW(strh::string_column::read(truncated), std::runtime_error);
+
+    for (uint64_t count: {UINT64_MAX, uint64_t(UINT32_MAX), uint64_t(1) << 30})
+    {
+        std::string corrupt = stream.str();
+        std::memcpy(corrupt.data() + 8, &count, sizeof(count));
+        std::stringstream corrupt_stream(corrupt);
+        ASSERT_THROW(strh::string_column::read(corrupt_stream), std::runtime_error);
+    }
+}
+
+struct quote
+{
+    std::string_view symbol;
+    char side = ' ';
+    double price = 0;
+    long long size = 0;
+    std::string venue;
+
+    using record_fields = strh::fields<strh::field<&quote::price, 3>,
+                                       strh::field<&quote::symbol, 0>,
+                                       strh::field<&quote::size, 4>,
+                                       strh::field<&quote::side, 1>>;
+};
+
+struct upper_parser
+{
+    bool operator()(std::string_view token, std::string &value) const
+    {
+        value = strh::swap_cases(std::string(token));
+        return true;
+    }
+};
+
+TEST(parse_record, basic)
+{
+    std::string line = "ESZ4|B|not a number|5912.25|12|cme";
+    auto record = strh::parse_record<quote>(line, '|');
+    ASSERT_TRUE(record.has_value());
+    ASSERT_EQ(record->symbol, "ESZ4");
+    ASSERT_EQ(record->side, 'B');
+    ASSERT_EQ(record->price, 5912.25);
+    ASSERT_EQ(record->size, 12);
+    ASSERT_EQ(record->venue, "");
+}
+
+TEST(parse_record, errors)
+{
+    ASSERT_EQ(strh::parse_record<quote>("ESZ4|B||5912.25", '|').error(),
+              (strh::record_error{strh::errc::missing_field, 4}));
+    ASSERT_EQ(strh::parse_record<quote>("ESZ4|B||5912.25x|12", '|').error(),
+              (strh::record_error{strh::errc::invalid_field, 3}));
+    ASSERT_EQ(strh::parse_record<quote>("ESZ4|BS||5912.25|", '|').error(),
+              (strh::record_error{strh::errc::invalid_field, 1}));
+}
+
+TEST(parse_record, explicit_fields)
+{
+    using venue_fields = strh::fields<strh::field<&quote::venue, 5, upper_parser>,
+                                      strh::field<&quote::symbol, 0>>;
+    auto record = strh::parse_record<quote, venue_fields>("ESZ4,B,,5912.25,12,cme", ',');
+    ASSERT_EQ(record->symbol, "ESZ4");
+    ASSERT_EQ(record->venue, "CME");
+    ASSERT_EQ(record->size, 0);
+}
+
+TEST(constexpr_functions, static_asserts)
+{
+    static_assert(strh::count("ES|NQ|CL", '|') == 2);
+    static_assert(strh::count("ES|NQ|ES", "ES") == 2);
+    static_assert(strh::starts_with("35=D", "35="));
+    static_assert(strh::ends_with("ESZ4.CME", ".CME"));
+    static_assert(strh::is_in("ESZ4.CME", 'Z'));
+    static_assert(strh::all_nums("20241018"));
+    static_assert(!strh::all_uppercase("ESz4"));
+    static_assert(strh::all_spaces(" \t\n"));
+    static_assert(strh::find_first("ES|NQ|CL", "NQ") == 3);
+    static_assert(strh::find("ES|NQ|ES", "ES")[1] == 6);
+    static_assert(strh::split("ES|NQ|CL", '|')[2] == "CL");
+    static_assert(strh::split("ES, NQ", ", ").size() == 2);
+    static_assert(strh::split_lines("ES\nNQ\n").size() == 2);
+    static_assert(strh::strip("  ESZ4 \t") == "ESZ4");
+    static_assert(strh::nx::count("ES", "").error() == strh::errc::empty_key);
+}
+
+TEST(split_array, basic)
+{
+    constexpr auto symbols = strh::split_array<"ES|NQ||CL|", '|'>();
+    static_assert(symbols.size() == 4);
+    static_assert(symbols[0] == "ES" && symbols[2].empty() && symbols[3] == "CL");
+
+    constexpr auto tags = strh::split_array<"35=D; 49=ME; 56=CME", "; ">();
+    static_assert(tags.size() == 3 && tags[1] == "49=ME");
+
+    constexpr auto lines = strh::split_lines_array<"ESZ4\nNQZ4">();
+    ASSERT_EQ(std::vector<std::string>(lines.begin(), lines.end()), strh::split_lines("ESZ4\nNQZ4"));
+}
+
+TEST(literal_matchers, match_runtime_keys)
+{
+    std::mt19937 rng(42);
+    const std::string alphabet = "35=|8";
+    for (size_t length = 0; length < 80; length++)
+    {
+        std::string string;
+        for (size_t i = 0; i < length; i++)
+            string += alphabet[rng() % alphabet.length()];
+
+        ASSERT_EQ(strh::find<"35=">(string), strh::find(string, "35="));
+        ASSERT_EQ(strh::find<"|">(string), strh::find(string, "|"));
+        ASSERT_EQ(strh::count<"35">(string), strh::count(string, "35"));
+        ASSERT_EQ(strh::count<"=|=3">(string), strh::count(string, "=|=3"));
+        ASSERT_EQ(strh::split<'|'>(string), strh::split(string, '|'));
+        ASSERT_EQ(strh::split<"|8">(string), strh::split(string, "|8"));
+        ASSERT_EQ((strh::replace<"35=", "X">(string)), strh::replace(string, "35=", "X"));
+        ASSERT_EQ((strh::replace<"|", "<|>">(string)), strh::replace(string, "|", "<|>"));
+    }
+}
+
+TEST(compiled_format, basic)
+{
+    constexpr auto quote = strh::compile<"{}|{}|{:.2f}">;
+    static_assert(quote.arg_count == 3);
+    ASSERT_EQ(quote.format("ESZ4", 12, 5912.256), "ESZ4|12|5912.26");
+    ASSERT_EQ(strh::compile<"{}">.format(std::string("NQZ4")), "NQZ4");
+    ASSERT_EQ(strh::compile<"{{{}}} {:x} {} {} {}">.format(-7LL, 255u, true, 'B', 0.5), "{-7} ff true B 0.5");
+    ASSERT_EQ(strh::compile<"no fields">.format(), "no fields");
+}
+
+TEST(compiled_format, format_to)
+{
+    constexpr auto message = strh::compile<"35=D|55={}|44={:.4f}|38={}|">;
+    std::string_view symbol = "CLF5";
+    char buffer[64];
+    ASSERT_LE(message.max_length(symbol, 71.5, 100), sizeof(buffer));
+    char *end = message.format_to(buffer, symbol, 71.5, 100);
+    ASSERT_EQ(std::string_view(buffer, end), "35=D|55=CLF5|44=71.5000|38=100|");
+}
+
+TEST(compiled_format, max_length)
+{
+    constexpr auto fields = strh::compile<"{} {:.2f} {} {:x}">;
+    long long min = std::numeric_limits<long long>::min();
+    double huge = std::numeric_limits<double>::max();
+    std::string formatted = fields.format(min, -huge, -huge, ~0ULL);
+    ASSERT_LE(formatted.length(), fields.max_length(min, -huge, -huge, ~0ULL));
+    ASSERT_EQ(formatted.substr(0, 21), "-9223372036854775808 ");
+
+    long double larger = 1e400L;
+    formatted = strh::compile<"{:.2f}">.format(larger);
+    ASSERT_EQ(formatted.length(), 404);
+    ASSERT_TRUE(formatted.starts_with("1000"));
+    ASSERT_TRUE(formatted.ends_with(".00"));
+}
+
+static size_t naive_edit_distance(std::string_view a, std::string_view b)
+{
+    std::vector<size_t> row(b.length() + 1);
+    for (size_t j = 0; j <= b.length(); j++)
+        row[j] = j;
+    for (size_t i = 1; i <= a.length(); i++)
+    {
+        size_t diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.length(); j++)
+        {
+            size_t above = row[j];
+            row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] != b[j - 1])});
+            diagonal = above;
+        }
+    }
+    return row[b.length()];
+}
+
+TEST(edit_distance, basic)
+{
+    ASSERT_EQ(strh::edit_distance("", ""), 0);
+    ASSERT_EQ(strh::edit_distance("", "ESZ4"), 4);
+    ASSERT_EQ(strh::edit_distance("ESZ4", ""), 4);
+    ASSERT_EQ(strh::edit_distance("ESZ4", "ESZ4"), 0);
+    ASSERT_EQ(strh::edit_distance("ESZ4", "ESH5"), 2);
+    ASSERT_EQ(strh::edit_distance("kitten", "sitting"), 3);
+    ASSERT_EQ(strh::edit_distance("AAPL", "APPL"), 1);
+    ASSERT_EQ(strh::edit_distance("MSFT", "MFST"), 2);
+}
+
+TEST(edit_distance, random)
+{
+    std::mt19937 rng(7);
+    for (size_t length: {3, 20, 63, 64, 65, 130, 200})
+    {
+        for (int trial = 0; trial < 20; trial++)
+        {
+            std::string a;
+            std::string b;
+            for (size_t i = 0; i < length; i++)
+                a += static_cast<char>('A' + rng() % 4);
+            long b_length = static_cast<long>(length) + static_cast<long>(rng() % 11) - 5;
+            for (long i = 0; i < b_length; i++)
+                b += static_cast<char>('A' + rng() % 4);
+            size_t expected = naive_edit_distance(a, b);
+            ASSERT_EQ(strh::edit_distance(a, b), expected);
+            ASSERT_EQ(strh::edit_distance(b, a), expected);
+            ASSERT_EQ(strh::fuzzy_pattern(a).distance(b), expected);
+            ASSERT_TRUE(strh::within_distance(a, b, expected));
+            if (expected > 0)
+            {
+                ASSERT_FALSE(strh::within_distance(a, b, expected - 1));
+            }
+        }
+    }
+}
+
+TEST(within_distance, basic)
+{
+    ASSERT_TRUE(strh::within_distance("ESZ4", "ESZ4", 0));
+    ASSERT_TRUE(strh::within_distance("ESZ4", "ESH4", 1));
+    ASSERT_FALSE(strh::within_distance("ESZ4", "NQH5", 2));
+    ASSERT_FALSE(strh::within_distance("ES", "ESZ4", 1));
+    ASSERT_TRUE(strh::within_distance("", "ES", 2));
+}
+
+TEST(nearest, basic)
+{
+    std::vector<std::string> symbols = {"AAPL", "MSFT", "APPL", "AAPL", "GOOG", "AMZN", "AAL"};
+    ASSERT_EQ(strh::nearest("AAPL", symbols, 3),
+              (std::vector<strh::fuzzy_match>{{0, 0}, {3, 0}, {2, 1}}));
+    ASSERT_EQ(strh::nearest("APL", symbols, 2), (std::vector<strh::fuzzy_match>{{0, 1}, {2, 1}}));
+    ASSERT_EQ(strh::nearest("MSFX", symbols, 5, 1), (std::vector<strh::fuzzy_match>{{1, 1}}));
+    ASSERT_TRUE(strh::nearest("AAPL", symbols, 0).empty());
+
+    strh::string_column column;
+    for (const std::string &symbol: symbols)
+        column.push_back(symbol);
+    ASSERT_EQ(strh::nearest("GOOGL", column, 1), (std::vector<strh::fuzzy_match>{{4, 1}}));
+}
+
+TEST(nearest, random)
+{
+    std::mt19937 rng(11);
+    std::vector<std::string> symbols;
+    for (int i = 0; i < 500; i++)
+    {
+        std::string symbol;
+        for (size_t j = 0, length = 1 + rng() % 8; j < length; j++)
+            symbol += static_cast<char>('A' + rng() % 6);
+        symbols.push_back(symbol);
+    }
+
+    for (std::string_view query: {"ABC", "FEDCBA", "AAAAAAAA", "B"})
+    {
+        std::vector<strh::fuzzy_match> expected;
+        for (size_t i = 0; i < symbols.size(); i++)
+            expected.push_back({i, naive_edit_distance(query, symbols[i])});
+        std::stable_sort(expected.begin(), expected.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.distance < rhs.distance;
+        });
+        expected.resize(10);
+        ASSERT_EQ(strh::nearest(query, symbols, 10), expected);
+    }
+}
+
+TEST(nearest, long_query_allocates_per_search)
+{
+    std::string query = strh::multiply("ESZ4.CME|", 10);
+    std::vector<std::string> strings;
+    for (int i = 0; i < 100; i++)
+        strings.push_back(query.substr(i % 7) + std::to_string(i));
+    std::vector<strh::fuzzy_match> found;
+    // The result, the match masks and the scratch space, however many strings are searched.
+    EXPECT_ALLOCS(3, found = strh::nearest(query, strings, 5));
+    ASSERT_EQ(found.size(), 5);
+    ASSERT_EQ(found[0].distance, strh::edit_distance(query, strings[found[0].index]));
+}
+
+static bool naive_glob(std::string_view pattern, std::string_view string)
+{
+    if (pattern.empty())
+        return string.empty();
+    if (pattern[0] == '*')
+        return naive_glob(pattern.substr(1), string) || (!string.empty() && naive_glob(pattern, string.substr(1)));
+    return !string.empty() && (pattern[0] == '?' || pattern[0] == string[0])
+           && naive_glob(pattern.substr(1), string.substr(1));
+}
+
+TEST(glob, basic)
+{
+    strh::glob cme("ES*.CME");
+    ASSERT_TRUE(cme.matches("ESZ4.CME"));
+    ASSERT_TRUE(cme.matches("ES.CME"));
+    ASSERT_FALSE(cme.matches("ESZ4.CBT"));
+    ASSERT_FALSE(cme.matches("NQZ4.CME"));
+    ASSERT_FALSE(cme.matches("ES.CM"));
+    ASSERT_EQ(cme.min_length(), 6);
+
+    strh::glob nq("?NQ*");
+    ASSERT_TRUE(nq.matches("MNQZ4"));
+    ASSERT_TRUE(nq.matches("MNQ"));
+    ASSERT_FALSE(nq.matches("NQZ4"));
+
+    ASSERT_TRUE(strh::glob("*").matches(""));
+    ASSERT_TRUE(strh::glob("*").matches("ESZ4"));
+    ASSERT_TRUE(strh::glob("").matches(""));
+    ASSERT_FALSE(strh::glob("").matches("E"));
+    ASSERT_TRUE(strh::glob("ESZ4").is_literal());
+    ASSERT_FALSE(strh::glob("ES?4").is_literal());
+    ASSERT_TRUE(strh::glob("ES?4").matches("ESH4"));
+    ASSERT_TRUE(strh::glob("*|55=??*|").matches("35=D|55=ESZ4|54=1|"));
+    ASSERT_FALSE(strh::glob("*|55=??*|").matches("35=D|55=E|"));
+    ASSERT_TRUE(strh::glob("a*b*a").matches("aba"));
+    ASSERT_FALSE(strh::glob("a*a").matches("a"));
+}
+
+TEST(glob, random)
+{
+    std::mt19937 rng(5);
+    for (int trial = 0; trial < 2000; trial++)
+    {
+        std::string pattern;
+        for (size_t i = 0, length = rng() % 7; i < length; i++)
+            pattern += "ab*?"[rng() % 4];
+        std::string string;
+        for (size_t i = 0, length = rng() % 8; i < length; i++)
+            string += "ab"[rng() % 2];
+        ASSERT_EQ(strh::glob(pattern).matches(string), naive_glob(pattern, string)) << pattern << " " << string;
+    }
+}
+
+TEST(glob_set, basic)
+{
+    strh::glob_set subscriptions;
+    ASSERT_EQ(subscriptions.add("ES*.CME"), 0);
+    ASSERT_EQ(subscriptions.add("?NQ*"), 1);
+    ASSERT_EQ(subscriptions.add("ESZ4.CME"), 2);
+    ASSERT_EQ(subscriptions.add("*"), 3);
+    ASSERT_EQ(subscriptions.add("E*4*"), 4);
+    ASSERT_EQ(subscriptions.add("ESZ4.CME"), 5);
+    ASSERT_EQ(subscriptions.size(), 6);
+    ASSERT_EQ(subscriptions[1].pattern(), "?NQ*");
+
+    ASSERT_EQ(subscriptions.matches("ESZ4.CME"), (std::vector<size_t>{0, 2, 3, 4, 5}));
+    ASSERT_EQ(subscriptions.matches("MNQH5"), (std::vector<size_t>{1, 3}));
+    ASSERT_EQ(subscriptions.matches(""), (std::vector<size_t>{3}));
+
+    strh::glob_set none;
+    none.add("ES*");
+    none.add("NQ");
+    ASSERT_TRUE(none.matches_any("ESZ4"));
+    ASSERT_TRUE(none.matches_any("NQ"));
+    ASSERT_FALSE(none.matches_any("NQZ4"));
+    ASSERT_FALSE(none.matches_any(""));
+}
+
+TEST(glob_set, random)
+{
+    std::mt19937 rng(9);
+    strh::glob_set set;
+    std::vector<std::string> patterns;
+    for (int i = 0; i < 300; i++)
+    {
+        std::string pattern;
+        for (size_t j = 0, length = rng() % 7; j < length; j++)
+            pattern += "abc*?"[rng() % 5];
+        patterns.push_back(pattern);
+        set.add(pattern);
+    }
+
+    for (int trial = 0; trial < 300; trial++)
+    {
+        std::string string;
+        for (size_t i = 0, length = rng() % 8; i < length; i++)
+            string += "abc"[rng() % 3];
+        std::vector<size_t> expected;
+        for (size_t id = 0; id < patterns.size(); id++)
+        {
+            if (naive_glob(patterns[id], string))
+                expected.push_back(id);
+        }
+        ASSERT_EQ(set.matches(string), expected) << string;
+        ASSERT_EQ(set.matches_any(string), !expected.empty());
+    }
+}
+
+TEST(histogram, basic)
+{
+    std::array<size_t, 256> counts = strh::histogram("35=D|55=ESZ4|\n");
+    ASSERT_EQ(counts['|'], 2);
+    ASSERT_EQ(counts['5'], 3);
+    ASSERT_EQ(counts['\n'], 1);
+    ASSERT_EQ(counts['x'], 0);
+    ASSERT_EQ(strh::histogram(""), (std::array<size_t, 256>{}));
+
+    std::string bytes;
+    for (int i = 0; i < 1000; i++)
+        bytes += static_cast<char>(i % 256);
+    std::array<size_t, 256> all = strh::histogram(bytes);
+    ASSERT_EQ(all[0], 4);
+    ASSERT_EQ(all[255], 3);
+    ASSERT_EQ(all[0xe8], 3);
+    ASSERT_EQ(all[0xe7], 4);
+}
+
+TEST(count_any, basic)
+{
+    std::string_view string = "35=D|55=\"ES Z4\"|44=5912.25|\n38=1|\n";
+    ASSERT_EQ(strh::count_any(string, "|\"\n"), (std::vector<size_t>{4, 2, 2}));
+    ASSERT_EQ(strh::count_any(string, "|"), (std::vector<size_t>{4}));
+    ASSERT_TRUE(strh::count_any(string, "").empty());
+    ASSERT_EQ(strh::count_any("", "ab"), (std::vector<size_t>{0, 0}));
+}
+
+TEST(count_any, random)
+{
+    std::mt19937 rng(1);
+    std::string string;
+    for (int i = 0; i < 10000; i++)
+        string += static_cast<char>('a' + rng() % 12);
+    for (std::string_view keys: {"a", "ab", "abc", "abcdefg", "abcdefgh", "abcdefghi", "lkjihgfedcbaz", "aa"})
+    {
+        std::vector<size_t> expected;
+        for (char key: keys)
+            expected.push_back(strh::count(string, key));
+        ASSERT_EQ(strh::count_any(string, keys), expected) << keys;
+        ASSERT_EQ(strh::count_any(std::string_view(string).substr(3, 37), keys)[0],
+                  strh::count(std::string_view(string).substr(3, 37), keys[0]));
+    }
+}
+
+TEST(prefix_set, basic)
+{
+    strh::prefix_set routes;
+    ASSERT_EQ(routes.match("35=D"), strh::prefix_set::npos);
+    ASSERT_EQ(routes.add("35=D"), 0);
+    ASSERT_EQ(routes.add("35="), 1);
+    ASSERT_EQ(routes.add("35=8"), 2);
+    ASSERT_EQ(routes.add("8=FIX"), 3);
+    ASSERT_EQ(routes.add("35="), 1);
+    ASSERT_EQ(routes.size(), 4);
+    ASSERT_EQ(routes[3], "8=FIX");
+
+    ASSERT_EQ(routes.match("35=D|55=ESZ4"), 0);
+    ASSERT_EQ(routes.match("35=8|"), 2);
+    ASSERT_EQ(routes.match("35=G|"), 1);
+    ASSERT_EQ(routes.match("35="), 1);
+    ASSERT_EQ(routes.match("35"), strh::prefix_set::npos);
+    ASSERT_EQ(routes.match("8=FIX.4.4"), 3);
+    ASSERT_EQ(routes.match(""), strh::prefix_set::npos);
+
+    ASSERT_EQ(routes.add(""), 4);
+    ASSERT_EQ(routes.match("9=12"), 4);
+    ASSERT_EQ(routes.match("35=8"), 2);
+}
+
+TEST(prefix_set, from_range)
+{
+    std::vector<std::string> routes = {"35=D", "35=", "35=8", "35=", "8=FIX"};
+    strh::prefix_set set(routes);
+    ASSERT_EQ(set.size(), 4);
+    ASSERT_EQ(set[3], "8=FIX");
+    ASSERT_EQ(set.match("35=D|55=ESZ4"), 0);
+    ASSERT_EQ(set.match("35=G|"), 1);
+    ASSERT_EQ(set.match("8=FIX.4.4"), 3);
+    ASSERT_EQ(set.add("35=8"), 2);
+    ASSERT_EQ(set.add("35=F"), 4);
+    ASSERT_EQ(set.match("35=F|"), 4);
+}
+
+TEST(suffix_set, basic)
+{
+    strh::suffix_set venues;
+    ASSERT_EQ(venues.add(".CME"), 0);
+    ASSERT_EQ(venues.add("E"), 1);
+    ASSERT_EQ(venues.add(".CBOE"), 2);
+    ASSERT_EQ(venues.match("ESZ4.CME"), 0);
+    ASSERT_EQ(venues.match("SPX.CBOE"), 2);
+    ASSERT_EQ(venues.match("CLF5.NYMEX"), strh::suffix_set::npos);
+    ASSERT_EQ(venues.match("BOE"), 1);
+}
+
+TEST(prefix_set, random)
+{
+    std::mt19937 rng(4);
+    strh::prefix_set prefixes;
+    std::vector<std::string> strings;
+    for (int i = 0; i < 200; i++)
+    {
+        std::string string;
+        for (size_t j = 0, length = 1 + rng() % 6; j < length; j++)
+            string += static_cast<char>('a' + rng() % 3);
+        if (std::find(strings.begin(), strings.end(), string) != strings.end())
+            continue;
+        strings.push_back(string);
+        prefixes.add(string);
+    }
+    strh::suffix_set suffixes(strings);
+
+    for (int trial = 0; trial < 500; trial++)
+    {
+        std::string string;
+        for (size_t j = 0, length = rng() % 9; j < length; j++)
+            string += static_cast<char>('a' + rng() % 3);
+        size_t longest_prefix = strh::prefix_set::npos;
+        size_t longest_suffix = strh::suffix_set::npos;
+        for (size_t id = 0; id < strings.size(); id++)
+        {
+            if (strh::starts_with(string, strings[id])
+                && (longest_prefix == strh::prefix_set::npos || strings[id].length() > strings[longest_prefix].length()))
+                longest_prefix = id;
+            if (strh::ends_with(string, strings[id])
+                && (longest_suffix == strh::suffix_set::npos || strings[id].length() > strings[longest_suffix].length()))
+                longest_suffix = id;
+        }
+        ASSERT_EQ(prefixes.match(string), longest_prefix) << string;
+        ASSERT_EQ(suffixes.match(string), longest_suffix) << string;
+    }
+}
+
+TEST(sort_tokens, basic)
+{
+    std::vector<std::string_view> tokens = {"NQZ4", "ES", "ESZ4", "", "ESZ4", "CLF5", "ES"};
+    strh::sort_tokens(tokens);
+    ASSERT_EQ(tokens, (std::vector<std::string_view>{"", "CLF5", "ES", "ES", "ESZ4", "ESZ4", "NQZ4"}));
+
+    std::vector<std::string_view> none;
+    strh::sort_tokens(none);
+    ASSERT_TRUE(none.empty());
+}
+
+TEST(sort_tokens, random)
+{
+    std::mt19937 rng(8);
+    std::vector<std::string> strings;
+    for (int i = 0; i < 3000; i++)
+    {
+        std::string string(rng() % 20, 'A');
+        for (char &ch: string)
+            ch = "AB\0\xff"[rng() % 4];
+        strings.push_back(string);
+    }
+    for (int i = 0; i < 500; i++)
+        strings.push_back(std::string("SPXW  241220C0590000") + static_cast<char>('0' + rng() % 10));
+
+    std::vector<std::string_view> tokens(strings.begin(), strings.end());
+    std::vector<std::string_view> expected = tokens;
+    std::sort(expected.begin(), expected.end());
+    strh::sort_tokens(tokens);
+    ASSERT_EQ(tokens, expected);
+}
+
+TEST(unique_tokens, basic)
+{
+    std::vector<std::string> tokens = strh::split("ES,NQ,ES,CL,,NQ,", ',');
+    ASSERT_EQ(strh::unique_tokens(tokens), (std::vector<std::string_view>{"ES", "NQ", "CL", ""}));
+    ASSERT_EQ(strh::count_distinct(tokens), 4);
+    ASSERT_EQ(strh::count_distinct(std::vector<std::string_view>{}), 0);
+
+    strh::string_column column;
+    strh::split("ES|NQ|ES|ES", '|', column);
+    ASSERT_EQ(strh::unique_tokens(column), (std::vector<std::string_view>{"ES", "NQ"}));
+    ASSERT_EQ(strh::count_distinct(column), 2);
+}
+
+TEST(unique_tokens, random)
+{
+    std::mt19937 rng(2);
+    std::vector<std::string> tokens;
+    for (int i = 0; i < 5000; i++)
+        tokens.push_back(std::to_string(rng() % 700));
+    std::unordered_set<std::string> distinct(tokens.begin(), tokens.end());
+    std::vector<std::string_view> unique = strh::unique_tokens(tokens);
+    ASSERT_EQ(unique.size(), distinct.size());
+    ASSERT_EQ(strh::count_distinct(tokens), distinct.size());
+    ASSERT_EQ(unique[0], tokens[0]);
+}
+
+TEST(line_index, basic)
+{
+    std::string_view text = "35=D|55=ES\n\n35=8|55=NQ\nlast";
+    strh::line_index index(text);
+    ASSERT_EQ(index.size(), 4);
+    ASSERT_EQ(index.line(0), "35=D|55=ES");
+    ASSERT_EQ(index.line(1), "");
+    ASSERT_EQ(index[2], "35=8|55=NQ");
+    ASSERT_EQ(index[3], "last");
+    ASSERT_EQ(index.line_start(2), 12);
+
+    ASSERT_EQ(index.line_of(0), 0);
+    ASSERT_EQ(index.line_of(10), 0);
+    ASSERT_EQ(index.line_of(11), 1);
+    ASSERT_EQ(index.line_of(12), 2);
+    ASSERT_EQ(index.line_of(text.length() - 1), 3);
+
+    ASSERT_EQ(strh::line_index("").size(), 0);
+    ASSERT_TRUE(strh::line_index().empty());
+    ASSERT_EQ(strh::line_index("ES\n").size(), 1);
+}
+
+TEST(line_index, matches_split_lines)
+{
+    std::mt19937 rng(6);
+    std::string text;
+    for (int i = 0; i < 5000; i++)
+        text += "\nab"[rng() % 3];
+    std::vector<std::string> lines = strh::split_lines(text);
+    strh::large_line_index index(text);
+    ASSERT_EQ(index.size(), lines.size());
+    for (size_t i = 0; i < lines.size(); i++)
+        ASSERT_EQ(index.line(i), lines[i]);
+}
+
+TEST(line_index, extend)
+{
+    std::string text = "35=D|55=ES\n35=8|5";
+    strh::line_index index(text);
+    ASSERT_EQ(index.size(), 2);
+    ASSERT_EQ(index[1], "35=8|5");
+
+    text += "5=NQ\n35=D|55=CL\n";
+    index.extend(text);
+    ASSERT_EQ(index.size(), 3);
+    ASSERT_EQ(index[1], "35=8|55=NQ");
+    ASSERT_EQ(index[2], "35=D|55=CL");
+    ASSERT_EQ(index.line_of(text.length() - 2), 2);
+    ASSERT_THROW(index.extend("35=D"), std::invalid_argument);
+    ASSERT_EQ(index.size(), 3);
+}
+
+TEST(line_index, threads)
+{
+    std::string text;
+    for (size_t i = 0; text.length() < (5 << 20); i++)
+        text += "35=D|55=ESZ4|38=" + std::to_string(i) + "|\n";
+    strh::line_index serial(text);
+    strh::line_index parallel(text, 4);
+    ASSERT_TRUE(std::ranges::equal(serial.newlines(), parallel.newlines()));
+    ASSERT_EQ(parallel[1000], "35=D|55=ESZ4|38=1000|");
+}
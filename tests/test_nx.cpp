@@ -0,0 +1,38 @@
+#include "gtest/gtest.h"
+#include "stringhelpers/stringhelpers.h"
+#include "stringhelpers/table.h"
+#include "stringhelpers/fixed_string.h"
+#include "stringhelpers/mapped_file.h"
+#include "stringhelpers/stream.h"
+
+TEST(nx, no_exceptions)
+{
+    ASSERT_FALSE(STRINGHELPERS_EXCEPTIONS);
+}
+
+TEST(nx, values)
+{
+    ASSERT_EQ(strh::nx::count("ES|NQ|ES", "ES"), 2);
+    ASSERT_EQ(strh::nx::split("ES|NQ", "|").value(), (std::vector<std::string>{"ES", "NQ"}));
+    ASSERT_EQ(strh::nx::find_first("ES|NQ|ES", "NQ"), 3);
+    ASSERT_TRUE(strh::nx::iis_in("ES|NQ", "nq").value());
+}
+
+TEST(nx, errors)
+{
+    ASSERT_EQ(strh::nx::count("ES", "").error(), strh::errc::empty_key);
+    ASSERT_EQ(strh::nx::starts_with("", 'E').error(), strh::errc::empty_string);
+    ASSERT_EQ(strh::nx::split("ES", "").error(), strh::errc::empty_delimiter);
+}
+
+TEST(nx, non_throwing_functions)
+{
+    ASSERT_EQ(strh::align("ES", strh::Alignment::LEFT, 4, '*'), "**ES");
+    ASSERT_EQ(strh::replace("ES|NQ", "|", ", "), "ES, NQ");
+    ASSERT_EQ(strh::fixed_string<7>("ESZ4"), "ESZ4");
+}
+
+TEST(nx, error_aborts)
+{
+    ASSERT_DEATH(strh::count("ES", ""), "");
+}
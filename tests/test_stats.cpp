@@ -0,0 +1,68 @@
+#include "gtest/gtest.h"
+#include "stringhelpers/stringhelpers.h"
+
+#include <thread>
+
+const strh::stats::function_stats &find_stats(const std::vector<strh::stats::function_stats> &stats,
+                                              strh::stats::function fn)
+{
+    return stats[static_cast<size_t>(fn)];
+}
+
+TEST(stats, enabled)
+{
+    ASSERT_TRUE(strh::stats::enabled);
+}
+
+TEST(stats, calls_and_bytes)
+{
+    auto before = find_stats(strh::stats::snapshot(), strh::stats::function::count);
+    strh::count("test", 't');
+    strh::count("tests", "st");
+    auto after = find_stats(strh::stats::snapshot(), strh::stats::function::count);
+
+    ASSERT_EQ(after.name, "count");
+    ASSERT_EQ(after.calls - before.calls, 2);
+    ASSERT_EQ(after.bytes - before.bytes, 9);
+}
+
+TEST(stats, histogram)
+{
+    auto before = find_stats(strh::stats::snapshot(), strh::stats::function::starts_with);
+    for (int i = 0; i < 10; i++)
+        strh::starts_with("test", "te");
+    auto after = find_stats(strh::stats::snapshot(), strh::stats::function::starts_with);
+
+    uint64_t histogram_calls = 0;
+    for (size_t i = 0; i < strh::stats::histogram_buckets; i++)
+        histogram_calls += after.histogram[i] - before.histogram[i];
+    ASSERT_EQ(histogram_calls, 10);
+}
+
+TEST(stats, allocations)
+{
+    auto before = find_stats(strh::stats::snapshot(), strh::stats::function::multiply);
+    std::string multiplied = strh::multiply("long enough to leave SSO", 4);
+    auto after = find_stats(strh::stats::snapshot(), strh::stats::function::multiply);
+
+    ASSERT_EQ(after.allocations - before.allocations, 1);
+}
+
+TEST(stats, merges_exited_threads)
+{
+    auto before = find_stats(strh::stats::snapshot(), strh::stats::function::strip);
+    std::thread([] {
+        for (int i = 0; i < 5; i++)
+            strh::strip(" test ");
+    }).join();
+    auto after = find_stats(strh::stats::snapshot(), strh::stats::function::strip);
+
+    ASSERT_EQ(after.calls - before.calls, 5);
+}
+
+TEST(stats, constexpr_functions)
+{
+    static_assert(strh::count("ES|NQ", '|') == 1);
+    static_assert(strh::strip(" ES ") == "ES");
+    ASSERT_EQ(strh::count("ES|NQ", '|'), 1);
+}